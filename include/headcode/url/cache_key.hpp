@@ -0,0 +1,132 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_CACHE_KEY_HPP
+#define HEADCODE_SPACE_URL_CACHE_KEY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   Selects the query parameters of a cache key.
+ */
+enum class ParameterFilter {
+    kAll = 0,        //!< @brief All parameters.
+    kAllow,          //!< @brief Only the listed parameters.
+    kDeny,           //!< @brief All but the listed parameters.
+    kNone            //!< @brief No parameters (no query at all).
+};
+
+
+/**
+ * @brief   The options of a cache key.
+ */
+struct CacheKeyOptions {
+    ParameterFilter filter_{ParameterFilter::kAll};        //!< @brief How to select the parameters.
+    std::vector<std::string> parameters_;                  //!< @brief The parameter names listed.
+    bool sort_parameters_{true};                           //!< @brief Sort the parameters by name, then value.
+    bool ignore_parameter_case_{false};                    //!< @brief Match, sort and write names in lower case.
+    bool lowercase_path_{false};                           //!< @brief Write the path in lower case.
+};
+
+
+/**
+ * @brief   Writes the canonical cache key of an URL.
+ *
+ * The key is
+ *
+ *      scheme "://" host [ ":" port ] path [ "?" parameter *( "&" parameter ) ]
+ *
+ * with scheme and host in lower case, IP literals in brackets, the port
+ * only if it is not the default port of the scheme, "/" for an empty path
+ * and the query parameters selected by the filter, optionally sorted.
+ * Empty parameters, userinfo and fragment are dropped.
+ *
+ * The options are prepared once at construction. Writing a key then is a
+ * single pass over the parsed URL without any allocation: either into a
+ * fixed buffer or straight into a 64 bit FNV-1a hash of the key. Only
+ * sorting more than 128 selected parameters takes a single heap buffer.
+ */
+class CacheKey {
+
+    CacheKeyOptions options_;        //!< @brief The options (with the names sorted for lookup).
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   options     the options of the cache keys.
+     */
+    explicit CacheKey(CacheKeyOptions options = {});
+
+    /**
+     * @brief   Returns the cache key as string (allocates; see Write() for the fixed buffer).
+     * @param   url         the parsed URL.
+     * @return  The cache key.
+     */
+    template <typename Policy>
+    [[nodiscard]] std::string Build(BasicURL<Policy> const & url) const;
+
+    /**
+     * @brief   Returns the 64 bit FNV-1a hash of the cache key without writing the key.
+     * @param   url         the parsed URL.
+     * @return  The hash of the cache key.
+     */
+    template <typename Policy>
+    [[nodiscard]] std::uint64_t Hash(BasicURL<Policy> const & url) const;
+
+    /**
+     * @brief   Writes the cache key into a buffer (not zero terminated).
+     *
+     * Like snprintf() the length of the whole key is returned: if it exceeds
+     * the buffer size only the first size bytes have been written.
+     *
+     * @param   url         the parsed URL.
+     * @param   buffer      the buffer to write to.
+     * @param   size        the size of the buffer.
+     * @return  The length of the cache key.
+     */
+    template <typename Policy>
+    std::size_t Write(BasicURL<Policy> const & url, char * buffer, std::size_t size) const;
+
+private:
+    /**
+     * @brief   Writes the cache key to a sink.
+     * @param   url         the parsed URL.
+     * @param   sink        receives the characters of the key.
+     */
+    template <typename Policy, typename Sink>
+    void Emit(BasicURL<Policy> const & url, Sink & sink) const;
+
+    /**
+     * @brief   Checks if a query parameter is selected by the filter.
+     * @param   parameter   the query parameter ("name=value" or "name").
+     * @return  true, if the parameter is part of the key.
+     */
+    [[nodiscard]] bool IsSelected(std::string_view parameter) const;
+};
+
+
+}
+
+
+#include "headcode/url/impl/cache_key_impl.hpp"
+
+
+#endif
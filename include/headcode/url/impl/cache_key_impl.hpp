@@ -0,0 +1,346 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_CACHE_KEY_IMPL_HPP
+#define HEADCODE_SPACE_URL_CACHE_KEY_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_CACHE_KEY_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Number of query parameters of a cache key sorted on the stack.
+ */
+constexpr std::size_t kCacheKeySortBufferSize = 128;
+
+
+/**
+ * @brief   Writes the characters of a cache key into a fixed buffer.
+ */
+class CacheKeyWriter {
+
+    char * buffer_;                  //!< @brief The buffer.
+    std::size_t size_;               //!< @brief The size of the buffer.
+    std::size_t length_{0};          //!< @brief The length of the key so far (may exceed the buffer).
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   buffer      the buffer.
+     * @param   size        the size of the buffer.
+     */
+    CacheKeyWriter(char * buffer, std::size_t size) : buffer_{buffer}, size_{size} {
+    }
+
+    /**
+     * @brief   Appends a character (dropped if the buffer is full).
+     * @param   c       the character.
+     */
+    void Append(char c) {
+        if (length_ < size_) {
+            buffer_[length_] = c;
+        }
+        ++length_;
+    }
+
+    /**
+     * @brief   Appends a string (truncated if the buffer is full).
+     * @param   s       the string.
+     */
+    void Append(std::string_view s) {
+        if (length_ < size_) {
+            std::copy_n(s.data(), std::min(s.size(), size_ - length_), buffer_ + length_);
+        }
+        length_ += s.size();
+    }
+
+    /**
+     * @brief   Appends a string in lower case (truncated if the buffer is full).
+     * @param   s       the string.
+     */
+    void AppendLower(std::string_view s) {
+        if (length_ < size_) {
+            CopyLower(buffer_ + length_, s.data(), std::min(s.size(), size_ - length_));
+        }
+        length_ += s.size();
+    }
+
+    /**
+     * @brief   Returns the length of the key.
+     * @return  The number of characters appended.
+     */
+    [[nodiscard]] std::size_t GetLength() const {
+        return length_;
+    }
+};
+
+
+/**
+ * @brief   Hashes the characters of a cache key with 64 bit FNV-1a.
+ */
+class CacheKeyHasher {
+
+    std::uint64_t hash_{14695981039346656037ull};        //!< @brief The FNV-1a offset basis.
+
+public:
+    /**
+     * @brief   Appends a character.
+     * @param   c       the character.
+     */
+    void Append(char c) {
+        hash_ = (hash_ ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+
+    /**
+     * @brief   Appends a string.
+     * @param   s       the string.
+     */
+    void Append(std::string_view s) {
+        for (auto c : s) {
+            Append(c);
+        }
+    }
+
+    /**
+     * @brief   Appends a string in lower case.
+     * @param   s       the string.
+     */
+    void AppendLower(std::string_view s) {
+        for (auto c : s) {
+            Append(ToLower(c));
+        }
+    }
+
+    /**
+     * @brief   Returns the hash.
+     * @return  The hash of all characters appended.
+     */
+    [[nodiscard]] std::uint64_t GetHash() const {
+        return hash_;
+    }
+};
+
+
+/**
+ * @brief   Appends a string in lower case to a sink.
+ * @param   sink        the sink.
+ * @param   s           the string.
+ */
+template <typename Sink>
+inline void AppendLower(Sink & sink, std::string_view s) {
+    sink.AppendLower(s);
+}
+
+
+/**
+ * @brief   Returns the name of a query parameter.
+ * @param   parameter       the query parameter ("name=value" or "name").
+ * @return  The name of the parameter.
+ */
+inline std::string_view GetParameterName(std::string_view parameter) {
+    return parameter.substr(0, parameter.find('='));
+}
+
+
+/**
+ * @brief   Compares two strings, optionally ignoring the case of ASCII letters.
+ * @param   lhs             the left string.
+ * @param   rhs             the right string.
+ * @param   ignore_case     compare in lower case.
+ * @return  < 0, 0 or > 0 as lhs is less, equal or greater than rhs.
+ */
+inline int CompareNames(std::string_view lhs, std::string_view rhs, bool ignore_case) {
+    if (!ignore_case) {
+        return lhs.compare(rhs);
+    }
+    auto n = std::min(lhs.size(), rhs.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        auto l = static_cast<unsigned char>(ToLower(lhs[i]));
+        auto r = static_cast<unsigned char>(ToLower(rhs[i]));
+        if (l != r) {
+            return l < r ? -1 : 1;
+        }
+    }
+    return (lhs.size() == rhs.size()) ? 0 : ((lhs.size() < rhs.size()) ? -1 : 1);
+}
+
+
+}
+
+
+inline headcode::url::CacheKey::CacheKey(CacheKeyOptions options) : options_{std::move(options)} {
+    // sorted once for a binary search per parameter
+    bool ignore_case = options_.ignore_parameter_case_;
+    std::sort(options_.parameters_.begin(),
+              options_.parameters_.end(),
+              [ignore_case](std::string const & lhs, std::string const & rhs) {
+                  return impl::CompareNames(lhs, rhs, ignore_case) < 0;
+              });
+}
+
+
+template <typename Policy>
+inline std::string headcode::url::CacheKey::Build(BasicURL<Policy> const & url) const {
+    std::string key(url.GetURL().size() + 8, '\0');
+    auto length = Write(url, key.data(), key.size());
+    if (length > key.size()) {
+        key.resize(length);
+        Write(url, key.data(), key.size());
+    }
+    key.resize(length);
+    return key;
+}
+
+
+template <typename Policy, typename Sink>
+inline void headcode::url::CacheKey::Emit(BasicURL<Policy> const & url, Sink & sink) const {
+
+    using namespace headcode::url::impl;
+
+    AppendLower(sink, url.GetScheme());
+    sink.Append("://");
+
+    bool ip_literal = (url.GetHostType() == HostType::kIPv6) || (url.GetHostType() == HostType::kIPvFuture);
+    if (ip_literal) {
+        sink.Append('[');
+    }
+    AppendLower(sink, url.GetHost());
+    if (ip_literal) {
+        sink.Append(']');
+    }
+
+    if (!url.GetPort().empty()) {
+        auto default_port = url.GetSchemeKind() != SchemeKind::kUnknown ? GetDefaultPort(url.GetSchemeKind())
+                                                                        : GetDefaultPort(url.GetScheme());
+        if (url.GetPortNumber() != default_port) {
+            sink.Append(':');
+            sink.Append(url.GetPort());
+        }
+    }
+
+    auto path = url.GetPath();
+    if (path.empty()) {
+        sink.Append('/');
+    } else if (options_.lowercase_path_) {
+        AppendLower(sink, path);
+    } else {
+        sink.Append(path);
+    }
+
+    if (options_.filter_ == ParameterFilter::kNone) {
+        return;
+    }
+
+    bool first{true};
+    auto append_parameter = [&](std::string_view parameter) {
+        sink.Append(first ? '?' : '&');
+        first = false;
+        if (options_.ignore_parameter_case_) {
+            auto name = GetParameterName(parameter);
+            AppendLower(sink, name);
+            sink.Append(parameter.substr(name.size()));
+        } else {
+            sink.Append(parameter);
+        }
+    };
+
+    auto parameters = url.QueryItems();
+    if (!options_.sort_parameters_) {
+        for (auto parameter : parameters) {
+            if (!parameter.empty() && IsSelected(parameter)) {
+                append_parameter(parameter);
+            }
+        }
+        return;
+    }
+
+    // Usual queries are sorted in a buffer on the stack. Longer ones are
+    // moved to the heap: one allocation keeps the sort at O(n log n).
+    using Entry = std::pair<std::string_view, std::string_view>;        // name, parameter
+    std::array<Entry, kCacheKeySortBufferSize> buffer;
+    std::vector<Entry> overflow;
+    std::size_t selected{0};
+    for (auto parameter : parameters) {
+        if (parameter.empty() || !IsSelected(parameter)) {
+            continue;
+        }
+        Entry entry{GetParameterName(parameter), parameter};
+        if (selected < buffer.size()) {
+            buffer[selected] = entry;
+        } else {
+            if (overflow.empty()) {
+                overflow.reserve(parameters.size());
+                overflow.assign(buffer.begin(), buffer.end());
+            }
+            overflow.push_back(entry);
+        }
+        ++selected;
+    }
+
+    auto sorted = overflow.empty() ? buffer.data() : overflow.data();
+    bool ignore_case = options_.ignore_parameter_case_;
+    std::sort(sorted, sorted + selected, [ignore_case](auto const & lhs, auto const & rhs) {
+        auto order = CompareNames(lhs.first, rhs.first, ignore_case);
+        return order != 0 ? order < 0 : lhs.second < rhs.second;
+    });
+    for (std::size_t i = 0; i < selected; ++i) {
+        append_parameter(sorted[i].second);
+    }
+}
+
+
+template <typename Policy>
+inline std::uint64_t headcode::url::CacheKey::Hash(BasicURL<Policy> const & url) const {
+    impl::CacheKeyHasher hasher;
+    Emit(url, hasher);
+    return hasher.GetHash();
+}
+
+
+inline bool headcode::url::CacheKey::IsSelected(std::string_view parameter) const {
+
+    if (options_.filter_ == ParameterFilter::kAll) {
+        return true;
+    }
+
+    bool ignore_case = options_.ignore_parameter_case_;
+    auto name = impl::GetParameterName(parameter);
+    bool listed = std::binary_search(options_.parameters_.begin(),
+                                     options_.parameters_.end(),
+                                     name,
+                                     [ignore_case](auto const & lhs, auto const & rhs) {
+                                         return impl::CompareNames(lhs, rhs, ignore_case) < 0;
+                                     });
+    return (options_.filter_ == ParameterFilter::kAllow) ? listed : !listed;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::CacheKey::Write(BasicURL<Policy> const & url,
+                                                  char * buffer,
+                                                  std::size_t size) const {
+    impl::CacheKeyWriter writer{buffer, size};
+    Emit(url, writer);
+    return writer.GetLength();
+}
+
+
+#endif
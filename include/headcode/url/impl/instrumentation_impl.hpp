@@ -0,0 +1,397 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_INSTRUMENTATION_IMPL_HPP
+#define HEADCODE_SPACE_URL_INSTRUMENTATION_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_INSTRUMENTATION_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <memory>
+
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+
+
+/**
+ * @brief   The counters of a single thread.
+ *
+ * Only the owning thread writes the counters, hence a relaxed load and store
+ * suffices for an increment. The atomics make the on demand reads of other
+ * threads well defined.
+ */
+class ThreadCounters {
+
+    std::array<std::atomic<std::uint64_t>, kParseStageCount> stage_counts_{};              //!< @brief Runs per stage.
+    std::array<std::atomic<std::uint64_t>, kParseStageCount> stage_nanoseconds_{};         //!< @brief Time per stage.
+    std::array<std::atomic<std::uint64_t>, kParseErrorCount> errors_{};                    //!< @brief Results.
+    std::atomic<std::uint64_t> offset_allocations_{0};                                   //!< @brief Offset allocations.
+    std::atomic<std::uint64_t> offset_allocated_bytes_{0};                               //!< @brief Offset bytes.
+
+public:
+    /**
+     * @brief   Ctor. Registers the counters.
+     */
+    ThreadCounters();
+
+    /**
+     * @brief   Dtor. Hands the counters over to the registry.
+     */
+    ~ThreadCounters();
+
+    /**
+     * @brief   Adds the counters to a statistics.
+     * @param   statistics      the statistics to add to.
+     */
+    void AddTo(ParseStatistics & statistics) const;
+
+    /**
+     * @brief   Counts an allocation of segment/query offsets.
+     * @param   bytes       the number of bytes allocated.
+     */
+    void CountAllocation(std::size_t bytes) {
+        Increment(offset_allocations_, 1);
+        Increment(offset_allocated_bytes_, bytes);
+    }
+
+    /**
+     * @brief   Counts a parse result.
+     * @param   error       the parse result.
+     */
+    void CountParse(ParseError error) {
+        auto index = static_cast<std::size_t>(error);
+        if (index < kParseErrorCount) {
+            Increment(errors_[index], 1);
+        }
+    }
+
+    /**
+     * @brief   Counts a run of a stage.
+     * @param   stage           the stage run.
+     * @param   nanoseconds     the time spent in the stage.
+     */
+    void CountStage(ParseStage stage, std::uint64_t nanoseconds) {
+        auto index = static_cast<std::size_t>(stage);
+        Increment(stage_counts_[index], 1);
+        Increment(stage_nanoseconds_[index], nanoseconds);
+    }
+
+private:
+    /**
+     * @brief   Increments a counter written by this thread only.
+     * @param   counter     the counter.
+     * @param   value       the value to add.
+     */
+    static void Increment(std::atomic<std::uint64_t> & counter, std::uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+};
+
+
+/**
+ * @brief   All thread counters of the process.
+ */
+struct CounterRegistry {
+    std::mutex mutex_;                                   //!< @brief Guards the registry.
+    std::vector<ThreadCounters const *> threads_;        //!< @brief Counters of the running threads.
+    ParseStatistics finished_;                           //!< @brief Counters of the finished threads.
+    ParseStatistics baseline_;                           //!< @brief Statistics at the last reset.
+};
+
+
+/**
+ * @brief   Returns the process wide counter registry.
+ * @return  The counter registry.
+ */
+inline CounterRegistry & GetCounterRegistry() {
+    static CounterRegistry registry;
+    return registry;
+}
+
+
+/**
+ * @brief   Returns the counters of the calling thread.
+ * @return  The thread-local counters.
+ */
+inline ThreadCounters & GetThreadCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+
+/**
+ * @brief   Adds (or subtracts) statistics.
+ * @param   lhs         the statistics to modify.
+ * @param   rhs         the statistics to add (or subtract).
+ * @param   sign        1 to add, -1 to subtract.
+ */
+inline void Accumulate(ParseStatistics & lhs, ParseStatistics const & rhs, int sign) {
+    auto accumulate = [sign](std::uint64_t & l, std::uint64_t r) { l = sign > 0 ? l + r : l - r; };
+    for (std::size_t i = 0; i < kParseStageCount; ++i) {
+        accumulate(lhs.stages_[i].count_, rhs.stages_[i].count_);
+        accumulate(lhs.stages_[i].nanoseconds_, rhs.stages_[i].nanoseconds_);
+    }
+    for (std::size_t i = 0; i < kParseErrorCount; ++i) {
+        accumulate(lhs.errors_[i], rhs.errors_[i]);
+    }
+    accumulate(lhs.parses_, rhs.parses_);
+    accumulate(lhs.offset_allocations_, rhs.offset_allocations_);
+    accumulate(lhs.offset_allocated_bytes_, rhs.offset_allocated_bytes_);
+}
+
+
+inline ThreadCounters::ThreadCounters() {
+    auto & registry = GetCounterRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex_};
+    registry.threads_.push_back(this);
+}
+
+
+inline ThreadCounters::~ThreadCounters() {
+    auto & registry = GetCounterRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex_};
+    AddTo(registry.finished_);
+    registry.threads_.erase(std::remove(registry.threads_.begin(), registry.threads_.end(), this),
+                            registry.threads_.end());
+}
+
+
+inline void ThreadCounters::AddTo(ParseStatistics & statistics) const {
+    for (std::size_t i = 0; i < kParseStageCount; ++i) {
+        statistics.stages_[i].count_ += stage_counts_[i].load(std::memory_order_relaxed);
+        statistics.stages_[i].nanoseconds_ += stage_nanoseconds_[i].load(std::memory_order_relaxed);
+    }
+    for (std::size_t i = 0; i < kParseErrorCount; ++i) {
+        auto count = errors_[i].load(std::memory_order_relaxed);
+        statistics.errors_[i] += count;
+        statistics.parses_ += count;
+    }
+    statistics.offset_allocations_ += offset_allocations_.load(std::memory_order_relaxed);
+    statistics.offset_allocated_bytes_ += offset_allocated_bytes_.load(std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief   Collects the statistics of all threads since the start of the process.
+ * @param   registry        the locked registry.
+ * @return  The total statistics.
+ */
+inline ParseStatistics CollectParseStatistics(CounterRegistry const & registry) {
+    ParseStatistics statistics = registry.finished_;
+    for (auto thread : registry.threads_) {
+        thread->AddTo(statistics);
+    }
+    return statistics;
+}
+
+
+#endif
+
+
+/**
+ * @brief   Counts a heap allocation of the segment/query offsets of an URL object.
+ * @param   bytes       the number of bytes allocated.
+ */
+inline void CountAllocation([[maybe_unused]] std::size_t bytes) {
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+    GetThreadCounters().CountAllocation(bytes);
+#endif
+}
+
+
+/**
+ * @brief   Counts the result of a parse.
+ * @param   error       the parse result.
+ */
+inline void CountParse([[maybe_unused]] ParseError error) {
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+    GetThreadCounters().CountParse(error);
+#endif
+}
+
+
+/**
+ * @brief   Measures the time spent in a stage until the end of the scope.
+ */
+class StageTimer {
+
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+
+    ParseStage stage_;                                      //!< @brief The stage measured.
+    std::chrono::steady_clock::time_point start_;         //!< @brief Start of the stage.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   stage       the stage to measure.
+     */
+    explicit StageTimer(ParseStage stage) : stage_{stage}, start_{std::chrono::steady_clock::now()} {
+    }
+
+    /**
+     * @brief   Dtor. Counts the stage.
+     */
+    ~StageTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        GetThreadCounters().CountStage(
+                stage_,
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    StageTimer(StageTimer const &) = delete;
+    StageTimer & operator=(StageTimer const &) = delete;
+
+#else
+
+public:
+    /**
+     * @brief   Ctor. Does nothing without instrumentation.
+     */
+    explicit constexpr StageTimer(ParseStage) {
+    }
+
+#endif
+};
+
+
+/**
+ * @brief   An allocator counting its allocations (the allocation hook of the segment/query offsets).
+ */
+template <typename T>
+class CountingAllocator {
+
+public:
+    using value_type = T;        //!< @brief The allocated type.
+
+    /**
+     * @brief   Ctor.
+     */
+    CountingAllocator() noexcept = default;
+
+    /**
+     * @brief   Converting Ctor.
+     */
+    template <typename U>
+    CountingAllocator(CountingAllocator<U> const &) noexcept {        // NOLINT(google-explicit-constructor)
+    }
+
+    /**
+     * @brief   Allocates and counts memory.
+     * @param   n       number of objects to allocate.
+     * @return  The allocated memory.
+     */
+    [[nodiscard]] T * allocate(std::size_t n) {
+        CountAllocation(n * sizeof(T));
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    /**
+     * @brief   Frees memory.
+     * @param   p       the memory to free.
+     * @param   n       number of objects allocated.
+     */
+    void deallocate(T * p, std::size_t n) noexcept {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    /**
+     * @brief   All counting allocators are equal.
+     * @return  true.
+     */
+    template <typename U>
+    bool operator==(CountingAllocator<U> const &) const noexcept {
+        return true;
+    }
+
+    /**
+     * @brief   All counting allocators are equal.
+     * @return  false.
+     */
+    template <typename U>
+    bool operator!=(CountingAllocator<U> const &) const noexcept {
+        return false;
+    }
+};
+
+
+/**
+ * @brief   The allocator of the segment/query offsets: counting with instrumentation, std::allocator else.
+ *
+ * The URL string itself (std::string) is not counted.
+ */
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+template <typename T>
+using URLAllocator = CountingAllocator<T>;
+#else
+template <typename T>
+using URLAllocator = std::allocator<T>;
+#endif
+
+
+}
+
+
+inline char const * headcode::url::GetParseStageName(ParseStage stage) {
+    switch (stage) {
+        case ParseStage::kScheme:
+            return "scheme";
+        case ParseStage::kAuthority:
+            return "authority";
+        case ParseStage::kPath:
+            return "path";
+        case ParseStage::kQuery:
+            return "query";
+        case ParseStage::kFragment:
+            return "fragment";
+        case ParseStage::kNormalize:
+            return "normalize";
+    }
+    return "unknown";
+}
+
+
+inline headcode::url::ParseStatistics headcode::url::GetParseStatistics() {
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+    auto & registry = impl::GetCounterRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex_};
+    auto statistics = impl::CollectParseStatistics(registry);
+    impl::Accumulate(statistics, registry.baseline_, -1);
+    return statistics;
+#else
+    return ParseStatistics{};
+#endif
+}
+
+
+inline void headcode::url::ResetParseStatistics() {
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+    auto & registry = impl::GetCounterRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex_};
+    registry.baseline_ = impl::CollectParseStatistics(registry);
+#endif
+}
+
+
+#endif
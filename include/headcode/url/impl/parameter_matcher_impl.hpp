@@ -0,0 +1,170 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_PARAMETER_MATCHER_IMPL_HPP
+#define HEADCODE_SPACE_URL_PARAMETER_MATCHER_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_PARAMETER_MATCHER_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <deque>
+#include <map>
+#include <utility>
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Flags of a node in the parameter trie.
+ */
+enum ParameterMatcherFlags : std::uint8_t {
+    kParameterName = 0x01,          //!< @brief A name rule ends at this node.
+    kParameterPrefix = 0x02         //!< @brief A prefix rule ("<this>*") ends at this node.
+};
+
+
+}
+
+
+inline headcode::url::ParameterMatcher::ParameterMatcher() : nodes_(1) {
+}
+
+
+inline headcode::url::ParameterMatcher::ParameterMatcher(std::string_view rules) : nodes_(1) {
+    Compile(rules);
+}
+
+
+inline std::size_t headcode::url::ParameterMatcher::Compile(std::string_view rules) {
+
+    // Strategy: collect all rules in a temporary tree keyed by characters.
+    // Afterwards flatten the tree breadth-first so that all children of a node
+    // are placed next to each other (sorted by character) in nodes_.
+
+    using namespace headcode::url::impl;
+
+    struct BuildNode {
+        std::map<char, BuildNode> children_;
+        std::uint8_t flags_{0};
+    };
+
+    BuildNode root;
+    std::size_t rule_count{0};
+
+    std::size_t line_start{0};
+    while (line_start < rules.size()) {
+
+        auto line_end = rules.find_first_of('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = rules.size();
+        }
+        auto line = rules.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+
+        // a rule is the first white space delimited token on a line
+        auto rule = line.substr(0, line.find_first_of(" \t\r"));
+        if (rule.empty() || (rule.substr(0, 2) == "//")) {
+            continue;
+        }
+
+        std::uint8_t flag = kParameterName;
+        if (rule.back() == '*') {
+            flag = kParameterPrefix;
+            rule.remove_suffix(1);
+        }
+
+        // the wildcard is only supported at the end, a name never holds a '=' or a '&'
+        if (rule.find_first_of("*=&") != std::string_view::npos) {
+            continue;
+        }
+
+        BuildNode * node = &root;
+        for (auto c : rule) {
+            node = &node->children_[c];
+        }
+        node->flags_ |= flag;
+        ++rule_count;
+    }
+
+    nodes_.assign(1, Node{});
+    nodes_[0].flags_ = root.flags_;
+
+    std::deque<std::pair<BuildNode const *, std::uint32_t>> queue;
+    queue.emplace_back(&root, 0);
+    while (!queue.empty()) {
+
+        auto [build_node, index] = queue.front();
+        queue.pop_front();
+
+        nodes_[index].first_child_ = static_cast<std::uint32_t>(nodes_.size());
+        nodes_[index].child_count_ = static_cast<std::uint16_t>(build_node->children_.size());
+        for (auto const & [c, child] : build_node->children_) {
+
+            Node node;
+            node.character_ = c;
+            node.flags_ = child.flags_;
+
+            queue.emplace_back(&child, static_cast<std::uint32_t>(nodes_.size()));
+            nodes_.push_back(node);
+        }
+    }
+
+    return rule_count;
+}
+
+
+inline std::uint32_t headcode::url::ParameterMatcher::FindChild(std::uint32_t node, char c) const {
+
+    std::uint32_t first = nodes_[node].first_child_;
+    std::uint32_t last = first + nodes_[node].child_count_;
+    while (first < last) {
+
+        auto middle = first + (last - first) / 2;
+        auto character = nodes_[middle].character_;
+        if (character == c) {
+            return middle;
+        }
+        if (character < c) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return 0;
+}
+
+
+inline bool headcode::url::ParameterMatcher::Matches(std::string_view name) const {
+
+    // Strategy: descend the trie along the name. Passing a node where a
+    // prefix rule ends is a match, else the whole name must end on a name rule.
+
+    std::uint32_t node{0};
+    for (auto c : name) {
+        if (nodes_[node].flags_ & impl::kParameterPrefix) {
+            return true;
+        }
+        node = FindChild(node, c);
+        if (node == 0) {
+            return false;
+        }
+    }
+
+    return (nodes_[node].flags_ & (impl::kParameterName | impl::kParameterPrefix)) != 0;
+}
+
+
+#endif
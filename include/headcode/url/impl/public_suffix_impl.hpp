@@ -0,0 +1,394 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_PUBLIC_SUFFIX_IMPL_HPP
+#define HEADCODE_SPACE_URL_PUBLIC_SUFFIX_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_PUBLIC_SUFFIX_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <deque>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <utility>
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Flags of a node in the public suffix trie.
+ */
+enum PublicSuffixFlags : std::uint8_t {
+    kPublicSuffixRule = 0x01,             //!< @brief A rule ends at this node.
+    kPublicSuffixWildcard = 0x02,         //!< @brief A wildcard rule ("*.<this>") ends at this node.
+    kPublicSuffixException = 0x04         //!< @brief An exception rule ("!<this>") ends at this node.
+};
+
+
+/**
+ * @brief   Magic bytes leading a serialized public suffix list.
+ */
+constexpr char kPublicSuffixMagic[] = {'H', 'C', 'S', 'P', 'S', 'L'};
+
+
+/**
+ * @brief   Version of the serialized public suffix list format.
+ */
+constexpr std::uint16_t kPublicSuffixVersion = 2;
+
+
+/**
+ * @brief   Compares a label stored in the trie with a label of a host.
+ * @param   stored      the stored label (lower case).
+ * @param   label       the label of the host (any case).
+ * @return  <0, 0 or >0 like std::string_view::compare().
+ */
+inline int ComparePublicSuffixLabel(std::string_view const & stored, std::string_view const & label) {
+
+    auto n = std::min(stored.size(), label.size());
+    for (std::size_t i = 0; i < n; ++i) {
+        auto a = static_cast<unsigned char>(stored[i]);
+        auto b = static_cast<unsigned char>(ToLower(label[i]));
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+
+    if (stored.size() == label.size()) {
+        return 0;
+    }
+    return stored.size() < label.size() ? -1 : 1;
+}
+
+
+/**
+ * @brief   Checks if the given host is an IP address (which has no public suffix).
+ * @param   host        the host to check.
+ * @return  true, if it is.
+ */
+inline bool IsIPAddressHost(std::string_view const & host) {
+    return (host.find_first_of(':') != std::string_view::npos) || IsIPv4(host);
+}
+
+
+}
+
+
+inline headcode::url::PublicSuffixList::PublicSuffixList() : nodes_(1) {
+}
+
+
+inline std::size_t headcode::url::PublicSuffixList::Compile(std::string_view rules) {
+
+    // Strategy: collect all rules in a temporary tree keyed by reversed labels.
+    // Afterwards flatten the tree breadth-first so that all children of a node
+    // are placed next to each other (sorted by label) in nodes_.
+
+    using namespace headcode::url::impl;
+
+    struct BuildNode {
+        std::map<std::string, BuildNode> children_;
+        std::uint8_t flags_{0};
+    };
+
+    BuildNode root;
+    std::size_t rule_count{0};
+
+    std::size_t line_start{0};
+    while (line_start < rules.size()) {
+
+        auto line_end = rules.find_first_of('\n', line_start);
+        if (line_end == std::string_view::npos) {
+            line_end = rules.size();
+        }
+        auto line = rules.substr(line_start, line_end - line_start);
+        line_start = line_end + 1;
+
+        // a rule is the first white space delimited token on a line
+        auto rule = line.substr(0, line.find_first_of(" \t\r"));
+        if (rule.empty() || (rule.substr(0, 2) == "//")) {
+            continue;
+        }
+
+        std::uint8_t flag = kPublicSuffixRule;
+        if (rule[0] == '!') {
+            flag = kPublicSuffixException;
+            rule.remove_prefix(1);
+        } else if (rule.substr(0, 2) == "*.") {
+            flag = kPublicSuffixWildcard;
+            rule.remove_prefix(2);
+        }
+
+        // wildcards are only supported as left most label, empty labels are bogus
+        if (rule.empty() || (rule.find_first_of('*') != std::string_view::npos) ||
+            (rule.find("..") != std::string_view::npos) || (rule.front() == '.') || (rule.back() == '.')) {
+            continue;
+        }
+
+        BuildNode * node = &root;
+        auto label_end = rule.size();
+        bool bad_label{false};
+        while (!bad_label) {
+
+            auto dot = rule.find_last_of('.', label_end - 1);
+            auto label_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+            std::string label{rule.substr(label_start, label_end - label_start)};
+            if (label.size() > 0xff) {
+                bad_label = true;
+                continue;
+            }
+            CopyLower(label.data(), label.data(), label.size());
+            node = &node->children_[label];
+
+            if (dot == std::string_view::npos) {
+                break;
+            }
+            label_end = dot;
+        }
+
+        if (!bad_label) {
+            node->flags_ |= flag;
+            ++rule_count;
+        }
+    }
+
+    nodes_.assign(1, Node{});
+    labels_.clear();
+
+    std::deque<std::pair<BuildNode const *, std::uint32_t>> queue;
+    queue.emplace_back(&root, 0);
+    while (!queue.empty()) {
+
+        auto [build_node, index] = queue.front();
+        queue.pop_front();
+
+        nodes_[index].first_child_ = static_cast<std::uint32_t>(nodes_.size());
+        nodes_[index].child_count_ = static_cast<std::uint32_t>(build_node->children_.size());
+        for (auto const & [label, child] : build_node->children_) {
+
+            Node node;
+            node.label_offset_ = static_cast<std::uint32_t>(labels_.size());
+            node.label_length_ = static_cast<std::uint8_t>(label.size());
+            node.flags_ = child.flags_;
+            labels_.append(label);
+
+            queue.emplace_back(&child, static_cast<std::uint32_t>(nodes_.size()));
+            nodes_.push_back(node);
+        }
+    }
+
+    return rule_count;
+}
+
+
+inline bool headcode::url::PublicSuffixList::Deserialize(std::string_view data) {
+
+    using namespace headcode::url::impl;
+
+    constexpr std::size_t header_size = sizeof(kPublicSuffixMagic) + 2 + 4 + 4;
+    constexpr std::size_t node_size = 4 + 4 + 4 + 1 + 1;
+
+    if ((data.size() < header_size) ||
+        (data.substr(0, sizeof(kPublicSuffixMagic)) !=
+         std::string_view{kPublicSuffixMagic, sizeof(kPublicSuffixMagic)})) {
+        return false;
+    }
+
+    auto p = data.data() + sizeof(kPublicSuffixMagic);
+    auto version = ReadLittleEndian<std::uint16_t>(p);
+    auto node_count = ReadLittleEndian<std::uint32_t>(p + 2);
+    auto labels_size = ReadLittleEndian<std::uint32_t>(p + 6);
+    p += 10;
+
+    if ((version != kPublicSuffixVersion) || (node_count == 0) ||
+        (data.size() != header_size + std::uint64_t{node_count} * node_size + labels_size)) {
+        return false;
+    }
+
+    std::vector<Node> nodes(node_count);
+    for (auto & node : nodes) {
+
+        node.label_offset_ = ReadLittleEndian<std::uint32_t>(p);
+        node.first_child_ = ReadLittleEndian<std::uint32_t>(p + 4);
+        node.child_count_ = ReadLittleEndian<std::uint32_t>(p + 8);
+        node.label_length_ = ReadLittleEndian<std::uint8_t>(p + 12);
+        node.flags_ = ReadLittleEndian<std::uint8_t>(p + 13);
+        p += node_size;
+
+        // never trust foreign data: all references must stay inside the blob
+        if ((std::uint64_t{node.label_offset_} + node.label_length_ > labels_size) ||
+            (std::uint64_t{node.first_child_} + node.child_count_ > node_count)) {
+            return false;
+        }
+    }
+
+    nodes_ = std::move(nodes);
+    labels_.assign(p, labels_size);
+
+    return true;
+}
+
+
+inline std::uint32_t headcode::url::PublicSuffixList::FindChild(std::uint32_t node, std::string_view label) const {
+
+    std::uint32_t first = nodes_[node].first_child_;
+    std::uint32_t last = first + nodes_[node].child_count_;
+    while (first < last) {
+
+        auto middle = first + (last - first) / 2;
+        auto const & child = nodes_[middle];
+        auto res = impl::ComparePublicSuffixLabel(
+                std::string_view{labels_}.substr(child.label_offset_, child.label_length_), label);
+        if (res == 0) {
+            return middle;
+        }
+        if (res < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    return 0;
+}
+
+
+inline std::size_t headcode::url::PublicSuffixList::FindPublicSuffix(std::string_view host) const {
+
+    // Strategy: walk the labels of the host from right to left and descend the
+    // trie along. The longest matching rule wins, an exception rule beats all.
+    // If no rule matches at all, the implicit rule "*" applies.
+
+    if (host.empty() || (host.front() == '.') || impl::IsIPAddressHost(host)) {
+        return std::string_view::npos;
+    }
+
+    std::uint32_t node{0};
+    std::size_t label_end = host.size();
+    std::size_t suffix_start = std::string_view::npos;
+    while (true) {
+
+        auto dot = host.find_last_of('.', label_end - 1);
+        auto label_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+        if (label_start == label_end) {
+            return std::string_view::npos;
+        }
+
+        if (suffix_start == std::string_view::npos) {
+            // implicit default rule: the top level label
+            suffix_start = label_start;
+        }
+
+        if (nodes_[node].flags_ & impl::kPublicSuffixWildcard) {
+            suffix_start = label_start;
+        }
+
+        auto child = FindChild(node, host.substr(label_start, label_end - label_start));
+        if (child == 0) {
+            break;
+        }
+
+        if (nodes_[child].flags_ & impl::kPublicSuffixException) {
+            // the exception's left most label is not part of the public suffix
+            return label_end + 1;
+        }
+        if (nodes_[child].flags_ & impl::kPublicSuffixRule) {
+            suffix_start = label_start;
+        }
+
+        if (dot == std::string_view::npos) {
+            break;
+        }
+        node = child;
+        label_end = dot;
+    }
+
+    return suffix_start;
+}
+
+
+inline std::string_view headcode::url::PublicSuffixList::GetPublicSuffix(std::string_view host) const {
+
+    if (!host.empty() && (host.back() == '.')) {
+        host.remove_suffix(1);
+    }
+    auto suffix_start = FindPublicSuffix(host);
+    if (suffix_start == std::string_view::npos) {
+        return std::string_view{};
+    }
+
+    return host.substr(suffix_start);
+}
+
+
+inline std::string_view headcode::url::PublicSuffixList::GetRegistrableDomain(std::string_view host) const {
+
+    if (!host.empty() && (host.back() == '.')) {
+        host.remove_suffix(1);
+    }
+    auto suffix_start = FindPublicSuffix(host);
+    if ((suffix_start == std::string_view::npos) || (suffix_start < 2)) {
+        return std::string_view{};
+    }
+
+    auto dot = host.find_last_of('.', suffix_start - 2);
+    auto domain_start = (dot == std::string_view::npos) ? 0 : dot + 1;
+    if (domain_start == suffix_start - 1) {
+        return std::string_view{};
+    }
+
+    return host.substr(domain_start);
+}
+
+
+inline bool headcode::url::PublicSuffixList::LoadFile(std::string const & file_name) {
+
+    std::ifstream in{file_name, std::ios::in | std::ios::binary};
+    if (!in) {
+        return false;
+    }
+
+    std::stringstream ss;
+    ss << in.rdbuf();
+    Compile(ss.str());
+
+    return true;
+}
+
+
+inline std::string headcode::url::PublicSuffixList::Serialize() const {
+
+    using namespace headcode::url::impl;
+
+    std::string data{kPublicSuffixMagic, sizeof(kPublicSuffixMagic)};
+    AppendLittleEndian(data, kPublicSuffixVersion);
+    AppendLittleEndian(data, static_cast<std::uint32_t>(nodes_.size()));
+    AppendLittleEndian(data, static_cast<std::uint32_t>(labels_.size()));
+
+    for (auto const & node : nodes_) {
+        AppendLittleEndian(data, node.label_offset_);
+        AppendLittleEndian(data, node.first_child_);
+        AppendLittleEndian(data, node.child_count_);
+        AppendLittleEndian(data, node.label_length_);
+        AppendLittleEndian(data, node.flags_);
+    }
+    data.append(labels_);
+
+    return data;
+}
+
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_REQUEST_TARGET_IMPL_HPP
+#define HEADCODE_SPACE_URL_REQUEST_TARGET_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_REQUEST_TARGET_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <tuple>
+
+
+inline void headcode::url::RequestTarget::Assign(std::string_view target, bool connect, ParseLimits const & limits) {
+    *this = RequestTarget{};
+    target_ = target;
+    error_ = Parse(connect, limits);
+    impl::CountParse(error_);
+}
+
+
+inline headcode::url::ParseError headcode::url::RequestTarget::Parse(bool connect, ParseLimits const & limits) {
+
+    // Strategy: the form is known after looking at the first character (or
+    // the request method). Each form then runs the very same stages as
+    // BasicURL::Parse() on the target itself, starting right at the component.
+
+    using namespace headcode::url::impl;
+
+    if (target_.empty()) {
+        return ParseError::kURLEmpty;
+    }
+    if (target_.size() > limits.max_length_) {
+        return ParseError::kURLTooLong;
+    }
+
+    ParseError error;
+    std::size_t pos;
+
+    if (connect) {
+
+        // authority-form: uri-host ":" port
+        form_ = RequestTargetForm::kAuthority;
+        {
+            [[maybe_unused]] StageTimer timer{ParseStage::kAuthority};
+            std::tie(error, pos) = impl::ParseAuthority(
+                    target_, 0, authority_, userinfo_, host_, host_address_, port_, port_number_);
+        }
+        if (error != ParseError::kNoError) {
+            return error;
+        }
+        if (pos != target_.size()) {
+            return ParseError::kInvalidPath;
+        }
+        if ((userinfo_.second > 0) || (target_[0] == '@')) {
+            return ParseError::kInvalidUserInfo;
+        }
+        if (host_.second == 0) {
+            return ParseError::kInvalidHost;
+        }
+        if (port_.second == 0) {
+            return ParseError::kInvalidPort;
+        }
+        return ParseError::kNoError;
+    }
+
+    if (target_ == "*") {
+        form_ = RequestTargetForm::kAsterisk;
+        return ParseError::kNoError;
+    }
+
+    if (target_[0] == '/') {
+        form_ = RequestTargetForm::kOrigin;
+        return ParsePathAndQuery(0, false, limits);
+    }
+
+    form_ = RequestTargetForm::kAbsolute;
+    {
+        [[maybe_unused]] StageTimer timer{ParseStage::kScheme};
+        std::tie(error, pos) = ParseScheme(target_, 0, scheme_, scheme_kind_);
+    }
+    if (error != ParseError::kNoError) {
+        return error;
+    }
+    ++pos;
+
+    bool authority_present = target_.substr(pos, 2) == "//";
+    if (authority_present) {
+        [[maybe_unused]] StageTimer timer{ParseStage::kAuthority};
+        std::tie(error, pos) = impl::ParseAuthority(
+                target_, pos + 2, authority_, userinfo_, host_, host_address_, port_, port_number_);
+        if (error != ParseError::kNoError) {
+            return error;
+        }
+    }
+
+    return ParsePathAndQuery(pos, authority_present, limits);
+}
+
+
+inline headcode::url::ParseError headcode::url::RequestTarget::ParsePathAndQuery(std::size_t start,
+                                                                                 bool authority_present,
+                                                                                 ParseLimits const & limits) {
+    using namespace headcode::url::impl;
+
+    // segments and query items are only counted to enforce the limits
+    OffsetCounter items;
+    ParseError error;
+    std::size_t pos;
+    {
+        [[maybe_unused]] StageTimer timer{ParseStage::kPath};
+        std::tie(error, pos) = ParsePath(target_, start, authority_present, path_, items, limits.max_segments_);
+    }
+    if (error != ParseError::kNoError) {
+        return error;
+    }
+
+    if ((pos < target_.size()) && (target_[pos] == '?')) {
+        [[maybe_unused]] StageTimer timer{ParseStage::kQuery};
+        query_present_ = true;
+        items.clear();
+        std::tie(error, pos) = ParseQuery(target_, pos + 1, query_, items, limits.max_query_items_);
+        if (error != ParseError::kNoError) {
+            return error;
+        }
+    }
+
+    // a fragment is never sent to a server
+    if (pos < target_.size()) {
+        return ParseError::kInvalidFragment;
+    }
+
+    return ParseError::kNoError;
+}
+
+
+#endif
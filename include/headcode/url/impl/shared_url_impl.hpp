@@ -0,0 +1,61 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_SHARED_URL_IMPL_HPP
+#define HEADCODE_SPACE_URL_SHARED_URL_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_SHARED_URL_HPP
+#error "Do not include this file directly."
+#endif
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Returns the empty URL shared by all default constructed SharedURL objects.
+ * @return  The shared empty URL.
+ * @tparam  Policy      the parse policy of the URL.
+ */
+template <typename Policy>
+inline std::shared_ptr<BasicURL<Policy>> const & GetSharedEmptyURL() {
+    static std::shared_ptr<BasicURL<Policy>> const empty = std::make_shared<BasicURL<Policy>>();
+    return empty;
+}
+
+
+}
+
+
+template <typename Policy>
+inline headcode::url::BasicSharedURL<Policy>::BasicSharedURL() : url_{impl::GetSharedEmptyURL<Policy>()} {
+}
+
+
+template <typename Policy>
+inline headcode::url::BasicURL<Policy> & headcode::url::BasicSharedURL<Policy>::Mutable() {
+
+    // Only this object refers to the URL if the count is 1: no other thread
+    // can copy it concurrently then. However use_count() loads the count
+    // relaxed: the acquire fence pairs with the release decrement of the
+    // thread which dropped the last other copy, so its reads of the URL
+    // happen before the writes following here.
+    if (url_.use_count() > 1) {
+        url_ = std::make_shared<BasicURL<Policy>>(*url_);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *url_;
+}
+
+
+#endif
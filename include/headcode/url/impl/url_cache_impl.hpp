@@ -0,0 +1,128 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_CACHE_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_CACHE_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_CACHE_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+
+template <typename Policy>
+inline headcode::url::BasicURLCache<Policy>::BasicURLCache(std::size_t capacity,
+                                                           std::size_t shards,
+                                                           ParseLimits const & limits)
+    : shards_(std::max<std::size_t>(shards, 1)), limits_{limits} {
+
+    shard_capacity_ = (capacity + shards_.size() - 1) / shards_.size();
+    for (auto & shard : shards_) {
+        shard.index_.reserve(shard_capacity_);
+        shard.entries_.reserve(shard_capacity_);
+    }
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLCache<Policy>::Clear() {
+    for (auto & shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex_};
+        shard.index_.clear();
+        shard.entries_.clear();
+        shard.hand_ = 0;
+    }
+}
+
+
+template <typename Policy>
+inline headcode::url::BasicSharedURL<Policy> headcode::url::BasicURLCache<Policy>::Get(std::string_view url) {
+
+    // too long: neither hashed, copied nor cached (the error result holds the first max_length_ + 1 characters)
+    if (url.size() > limits_.max_length_) {
+        return BasicSharedURL<Policy>{std::string{url.substr(0, limits_.max_length_ + 1)}, limits_};
+    }
+
+    // the low bits of the hash pick the bucket in the shard: take the high bits for the shard
+    auto hash = std::hash<std::string_view>{}(url);
+    auto & shard = shards_[(hash >> (sizeof(hash) * 4)) % shards_.size()];
+
+    {
+        std::lock_guard<std::mutex> lock{shard.mutex_};
+        auto iter = shard.index_.find(url);
+        if (iter != shard.index_.end()) {
+            auto & entry = shard.entries_[iter->second];
+            entry.referenced_ = true;
+            ++shard.hits_;
+            return entry.url_;
+        }
+        ++shard.misses_;
+    }
+
+    // parse without holding the lock: other threads may insert the same URL meanwhile
+    BasicSharedURL<Policy> parsed{std::string{url}, limits_};
+    if (shard_capacity_ > 0) {
+        std::lock_guard<std::mutex> lock{shard.mutex_};
+        auto iter = shard.index_.find(url);
+        if (iter != shard.index_.end()) {
+            return shard.entries_[iter->second].url_;
+        }
+        Insert(shard, parsed);
+    }
+
+    return parsed;
+}
+
+
+template <typename Policy>
+inline headcode::url::URLCacheStatistics headcode::url::BasicURLCache<Policy>::GetStatistics() {
+    URLCacheStatistics statistics;
+    for (auto & shard : shards_) {
+        std::lock_guard<std::mutex> lock{shard.mutex_};
+        statistics.hits_ += shard.hits_;
+        statistics.misses_ += shard.misses_;
+        statistics.evictions_ += shard.evictions_;
+        statistics.size_ += shard.entries_.size();
+    }
+    return statistics;
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLCache<Policy>::Insert(Shard & shard, BasicSharedURL<Policy> const & url) {
+
+    // The key is a view on the string of the cached URL itself: the URL
+    // is immutable and lives as long as the entry, so is the key.
+
+    if (shard.entries_.size() < shard_capacity_) {
+        shard.entries_.push_back(Entry{url, false});
+        shard.index_.emplace(std::string_view{url->GetURL()}, shard.entries_.size() - 1);
+        return;
+    }
+
+    // CLOCK: clear the reference bits until an entry not referenced is found
+    while (shard.entries_[shard.hand_].referenced_) {
+        shard.entries_[shard.hand_].referenced_ = false;
+        shard.hand_ = (shard.hand_ + 1) % shard.entries_.size();
+    }
+
+    auto & victim = shard.entries_[shard.hand_];
+    shard.index_.erase(std::string_view{victim.url_->GetURL()});
+    victim = Entry{url, false};
+    shard.index_.emplace(std::string_view{url->GetURL()}, shard.hand_);
+    shard.hand_ = (shard.hand_ + 1) % shard.entries_.size();
+    ++shard.evictions_;
+}
+
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_COLUMNS_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_COLUMNS_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_COLUMNS_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <functional>
+
+
+inline void headcode::url::StringDictionary::Clear() {
+    data_.clear();
+    offsets_.assign(1, 0);
+    slots_.clear();
+}
+
+
+inline std::uint32_t headcode::url::StringDictionary::Find(std::string_view value) const {
+    if (slots_.empty()) {
+        return kNotFound;
+    }
+    auto slot = slots_[FindSlot(value)];
+    return slot == 0 ? kNotFound : slot - 1;
+}
+
+
+inline std::size_t headcode::url::StringDictionary::FindSlot(std::string_view value) const {
+
+    // linear probing on a power of 2 sized table
+    auto mask = slots_.size() - 1;
+    auto pos = std::hash<std::string_view>{}(value) & mask;
+    while ((slots_[pos] != 0) && (Get(slots_[pos] - 1) != value)) {
+        pos = (pos + 1) & mask;
+    }
+
+    return pos;
+}
+
+
+inline void headcode::url::StringDictionary::Grow() {
+
+    std::vector<std::uint32_t> slots(slots_.empty() ? 16 : slots_.size() * 2, 0);
+    slots_.swap(slots);
+    for (std::uint32_t id = 0; id < Size(); ++id) {
+        slots_[FindSlot(Get(id))] = id + 1;
+    }
+}
+
+
+inline std::uint32_t headcode::url::StringDictionary::Insert(std::string_view value) {
+
+    auto id = Find(value);
+    if (id != kNotFound) {
+        return id;
+    }
+
+    // keep the load factor at most 0.5
+    if ((Size() + 1) * 2 > slots_.size()) {
+        Grow();
+    }
+
+    id = static_cast<std::uint32_t>(Size());
+    auto pos = FindSlot(value);
+    data_.append(value);
+    offsets_.push_back(data_.size());
+    slots_[pos] = id + 1;
+
+    return id;
+}
+
+
+inline void headcode::url::URLColumns::Append(URL const & url) {
+
+    scheme_ids_.push_back(schemes_.Insert(url.GetScheme()));
+    host_ids_.push_back(hosts_.Insert(url.GetHost()));
+
+    paths_.data_.append(url.GetPath());
+    paths_.offsets_.push_back(paths_.data_.size());
+    queries_.data_.append(url.GetQuery());
+    queries_.offsets_.push_back(queries_.data_.size());
+    fragments_.data_.append(url.GetFragment());
+    fragments_.offsets_.push_back(fragments_.data_.size());
+
+    errors_.push_back(url.GetError());
+    flags_.push_back((url.IsQueryPresent() ? kQueryPresent : 0) | (url.IsFragmentPresent() ? kFragmentPresent : 0));
+}
+
+
+inline void headcode::url::URLColumns::Clear() {
+
+    schemes_.Clear();
+    scheme_ids_.clear();
+    hosts_.Clear();
+    host_ids_.clear();
+    for (auto column : {&paths_, &queries_, &fragments_}) {
+        column->data_.clear();
+        column->offsets_.assign(1, 0);
+    }
+    errors_.clear();
+    flags_.clear();
+}
+
+
+inline void headcode::url::URLColumns::Reserve(std::size_t rows) {
+
+    scheme_ids_.reserve(rows);
+    host_ids_.reserve(rows);
+    for (auto column : {&paths_, &queries_, &fragments_}) {
+        column->offsets_.reserve(rows + 1);
+    }
+    errors_.reserve(rows);
+    flags_.reserve(rows);
+}
+
+
+#endif
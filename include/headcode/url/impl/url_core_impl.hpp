@@ -16,9 +16,19 @@
 
 
 #include <algorithm>
-#include <sstream>
+#include <array>
+#include <cstring>
 #include <tuple>
 
+#ifdef DEBUG
+#include <cassert>
+#endif
+
+#if !defined(HEADCODE_SPACE_URL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define HEADCODE_SPACE_URL_SSE2
+#include <emmintrin.h>
+#endif
+
 
 /**
  * @brief namespace for inner implementation details.
@@ -41,6 +51,34 @@ enum class ParserState {
 };
 
 
+/**
+ * @brief   Appends an integral value as little endian to a string.
+ * @param   data        the string to append to.
+ * @param   value       the value to append.
+ */
+template <typename T>
+inline void AppendLittleEndian(std::string & data, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        data.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+
+/**
+ * @brief   Reads an integral value stored as little endian.
+ * @param   data        the data to read from (at least sizeof(T) bytes).
+ * @return  The value read.
+ */
+template <typename T>
+inline T ReadLittleEndian(char const * data) {
+    T value{0};
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<T>(static_cast<T>(static_cast<unsigned char>(data[i])) << (i * 8));
+    }
+    return value;
+}
+
+
 /**
  * @brief   Checks if the given character is a valid ASCII (according to the RFC).
  * @param   c       the character to check.
@@ -62,42 +100,43 @@ inline bool IsDigit(char c) {
 
 
 /**
- * @brief   Checks if the given character is a valid dec-octet ('0' - '255').
- * @param   dec_octet       the dec-octet to test.
- * @return  true, if it is.
+ * @brief   Parses a dec-octet ('0' - '255').
+ * @param   dec_octet       the dec-octet to parse.
+ * @param   value           the value of the dec-octet.
+ * @return  true, if it is a valid dec-octet.
  */
-inline bool IsDecOctet(std::string_view const & dec_octet) {
+inline bool ParseDecOctet(std::string_view const & dec_octet, std::uint8_t & value) {
 
-    // a dec-octet is a string representing a value between 0 and 255.
-    int value = 0;
-    switch (dec_octet.size()) {
+    // dec-octet = DIGIT / %x31-39 DIGIT / "1" 2DIGIT / "2" %x30-34 DIGIT / "25" %x30-35
+    // i.e. a value between 0 and 255 without leading zeros.
+    if (dec_octet.empty() || (dec_octet.size() > 3) || ((dec_octet.size() > 1) && (dec_octet[0] == '0'))) {
+        return false;
+    }
 
-        case 0:
+    unsigned int v = 0;
+    for (auto c : dec_octet) {
+        if (!IsDigit(c)) {
             return false;
+        }
+        v = v * 10 + (c - '0');
+    }
+    if (v > 255) {
+        return false;
+    }
 
-        case 1:
-            // valid: 0-9
-            if (IsDigit(dec_octet[0])) {
-                value = dec_octet[0] - '0';
-            }
-            return value > 0;
-
-        case 2:
-            // valid: 10-99
-            if (IsDigit(dec_octet[0]) && IsDigit(dec_octet[1])) {
-                value = (dec_octet[0] - '0') * 10 + (dec_octet[1] - '0');
-            }
-            return value >= 10 && value < 100;
+    value = static_cast<std::uint8_t>(v);
+    return true;
+}
 
-        case 3:
-            // valid: 100-255
-            if (IsDigit(dec_octet[0]) && IsDigit(dec_octet[1]) && IsDigit(dec_octet[2])) {
-                value = (dec_octet[0] - '0') * 100 + (dec_octet[1] - '0') * 10 + (dec_octet[2] - '0');
-            }
-            return value >= 100 && value < 256;
-    }
 
-    return false;
+/**
+ * @brief   Checks if the given character is a valid dec-octet ('0' - '255').
+ * @param   dec_octet       the dec-octet to test.
+ * @return  true, if it is.
+ */
+inline bool IsDecOctet(std::string_view const & dec_octet) {
+    std::uint8_t value;
+    return ParseDecOctet(dec_octet, value);
 }
 
 
@@ -145,73 +184,173 @@ inline bool IsUnreserved(char c) {
 
 
 /**
- * @brief   Checks if the given string represents a IPv4 address
- * @param   host            the host to check.
- * @return  true, if it is.
+ * @brief   Returns the value of a HEXDIG.
+ * @param   c       the hex digit (must be a valid HEXDIG).
+ * @return  The value of the hex digit (0 - 15).
  */
-inline bool IsIPv4(std::string_view const & host) {
-
-    // strategy: split the sting in 4 dec-octet and check each dec-octet afterwards
-    // exit immediately if the char ain't a digit (0-9) or dot (.).
-
-    std::array<std::string_view, 4> octet;
+inline std::uint8_t HexDigitValue(char c) {
+    if (IsDigit(c)) {
+        return c - '0';
+    }
+    return ((c >= 'a') ? (c - 'a') : (c - 'A')) + 0x0a;
+}
 
-    std::size_t index{0};
-    std::string::size_type last{0};
-    std::string::size_type i{0};
-    for (; (i < host.size()) && (index < 4); ++i) {
 
-        if (host[i] == '.') {
-            octet[index++] = host.substr(last, i - last);
-            last = i + 1;
+/**
+ * @brief   Parses an IPv4 address.
+ * @param   host            the host to parse.
+ * @param   address         the parsed address in host byte order.
+ * @return  true, if the host is a valid IPv4 address.
+ */
+inline bool ParseIPv4(std::string_view const & host, std::uint32_t & address) {
+
+    // IPv4address = dec-octet "." dec-octet "." dec-octet "." dec-octet
+    // Strategy: single pass, accumulate each dec-octet while scanning.
+    // Exit immediately if the char ain't a digit (0-9) or dot (.).
+
+    std::uint32_t value{0};
+    unsigned int octet{0};
+    std::size_t digits{0};
+    std::size_t dots{0};
+    for (auto c : host) {
+
+        if (IsDigit(c)) {
+            if ((digits > 0) && (octet == 0)) {
+                // no leading zeros in a dec-octet
+                return false;
+            }
+            octet = octet * 10 + (c - '0');
+            if (octet > 255) {
+                return false;
+            }
+            ++digits;
             continue;
         }
 
-        if (!IsDigit(host[i])) {
-            return false;
+        if ((c == '.') && (digits > 0) && (dots < 3)) {
+            value = (value << 8) | octet;
+            octet = 0;
+            digits = 0;
+            ++dots;
+            continue;
         }
+
+        return false;
     }
 
-    // capturing final dec-octet
-    if ((i == host.size()) && (index != 4)) {
-        octet[index++] = host.substr(last, host.size() - last);
+    if ((dots != 3) || (digits == 0)) {
+        return false;
     }
 
-    return (index == 4) && std::all_of(octet.cbegin(), octet.cend(), [](auto const & sv) { return IsDecOctet(sv); });
+    address = (value << 8) | octet;
+    return true;
 }
 
 
 /**
- * @brief   Checks if the given string represents a IPv6 address
+ * @brief   Checks if the given string represents a IPv4 address
  * @param   host            the host to check.
  * @return  true, if it is.
  */
-inline bool IsIPv6(std::string_view const & host) {
+inline bool IsIPv4(std::string_view const & host) {
+    std::uint32_t address;
+    return ParseIPv4(host, address);
+}
 
-    // TODO: this is not a real IPv6 check. Improve this!
-    bool colon_present{false};
-    bool ipv4_present{false};
 
-    for (auto const & c : host) {
-        if (IsHexDigit(c)) {
-            continue;
+/**
+ * @brief   Parses an IPv6 address (RFC 4291, section 2.2 and RFC 3986, section 3.2.2).
+ * @param   host            the host to parse (without the enclosing '[' and ']').
+ * @param   address         the parsed address in network byte order.
+ * @return  true, if the host is a valid IPv6 address.
+ */
+inline bool ParseIPv6(std::string_view const & host, std::array<std::uint8_t, 16> & address) {
+
+    // Strategy: collect up to 8 h16 groups and remember where a "::" has been.
+    // A trailing ls32 may be given as IPv4 address. Finally expand the "::".
+
+    std::array<std::uint16_t, 8> groups{};
+    std::size_t count{0};
+    std::size_t compressed_at{std::string_view::npos};
+
+    std::size_t i{0};
+    if ((host.size() >= 2) && (host[0] == ':') && (host[1] == ':')) {
+        compressed_at = 0;
+        i = 2;
+    }
+
+    while (i < host.size()) {
+
+        if (count == groups.size()) {
+            return false;
         }
-        if ((c == ':') && !ipv4_present) {
-            colon_present = true;
-            continue;
+
+        auto start = i;
+        std::uint16_t value{0};
+        while ((i < host.size()) && (i - start < 4) && IsHexDigit(host[i])) {
+            value = static_cast<std::uint16_t>((value << 4) | HexDigitValue(host[i]));
+            ++i;
         }
-        if ((c == '.') && colon_present) {
-            ipv4_present = true;
-            continue;
+        if (i == start) {
+            return false;
         }
 
+        if ((i < host.size()) && (host[i] == '.')) {
+            // ls32 as IPv4 address: consumes the rest of the host
+            std::uint32_t ipv4;
+            if ((count > groups.size() - 2) || !ParseIPv4(host.substr(start), ipv4)) {
+                return false;
+            }
+            groups[count++] = static_cast<std::uint16_t>(ipv4 >> 16);
+            groups[count++] = static_cast<std::uint16_t>(ipv4 & 0xffff);
+            break;
+        }
+
+        groups[count++] = value;
+        if (i == host.size()) {
+            break;
+        }
+        if ((host[i] != ':') || (i + 1 == host.size())) {
+            return false;
+        }
+        ++i;
+
+        if (host[i] == ':') {
+            if (compressed_at != std::string_view::npos) {
+                return false;
+            }
+            compressed_at = count;
+            ++i;
+        }
+    }
+
+    bool compressed = compressed_at != std::string_view::npos;
+    if ((!compressed && (count != groups.size())) || (compressed && (count == groups.size()))) {
         return false;
     }
 
+    address.fill(0);
+    for (std::size_t g = 0; g < count; ++g) {
+        auto pos = (g < compressed_at) ? g : (g + groups.size() - count);
+        address[pos * 2] = static_cast<std::uint8_t>(groups[g] >> 8);
+        address[pos * 2 + 1] = static_cast<std::uint8_t>(groups[g] & 0xff);
+    }
+
     return true;
 }
 
 
+/**
+ * @brief   Checks if the given string represents a IPv6 address
+ * @param   host            the host to check.
+ * @return  true, if it is.
+ */
+inline bool IsIPv6(std::string_view const & host) {
+    std::array<std::uint8_t, 16> address;
+    return ParseIPv6(host, address);
+}
+
+
 /**
  * @brief   Checks if the given string represents a IPvFuture address
  * @param   host            the host to check.
@@ -220,7 +359,8 @@ inline bool IsIPv6(std::string_view const & host) {
 inline bool IsIPvFuture(std::string_view const & host) {
 
     std::string_view::size_type start_of_address{0};
-    if ((host.size() >= 4) && (host[0] == 'v')) {
+    // IPvFuture = "v" 1*HEXDIG "." 1*( unreserved / sub-delims / ":" )
+    if ((host.size() >= 4) && ((host[0] == 'v') || (host[0] == 'V'))) {
 
         bool version{true};
         for (std::string_view::size_type i = 1; i < host.size(); ++i) {
@@ -228,7 +368,7 @@ inline bool IsIPvFuture(std::string_view const & host) {
             if (version && IsHexDigit(host[i])) {
                 continue;
             }
-            if (version && (host[i] == '.')) {
+            if (version && (host[i] == '.') && (i > 1)) {
                 version = false;
                 continue;
             }
@@ -286,7 +426,7 @@ inline bool IsRegName(std::string_view const & host) {
         }
 
         // pct-encoded
-        if (host[i] == '%' && i < (host.size() - 2) && IsHexDigit(host[i + 1]) && IsHexDigit(host[i + 2])) {
+        if (host[i] == '%' && (i + 2) < host.size() && IsHexDigit(host[i + 1]) && IsHexDigit(host[i + 2])) {
             i += 2;
             continue;
         }
@@ -317,7 +457,7 @@ inline bool IsValidFragment(std::string_view const & fragment) {
         }
 
         // pct-encoded
-        if (fragment[i] == '%' && i < (fragment.size() - 2) && IsHexDigit(fragment[i + 1]) &&
+        if (fragment[i] == '%' && (i + 2) < fragment.size() && IsHexDigit(fragment[i + 1]) &&
             IsHexDigit(fragment[i + 2])) {
             i += 2;
             continue;
@@ -330,16 +470,111 @@ inline bool IsValidFragment(std::string_view const & fragment) {
 }
 
 
+/**
+ * @brief   Parses the host and identifies the type and binary address of it.
+ * @param   host                the host to parse.
+ * @param   host_address        the type and binary address of the host.
+ * @return  true, if the host is valid.
+ */
+inline bool ParseHost(std::string_view const & host, HostAddress & host_address) {
+
+    // host = IP-literal / IPv4address / reg-name
+
+    host_address = HostAddress{};
+    if (!host.empty() && (host[0] == '[')) {
+
+        if ((host.size() < 3) || (host[host.size() - 1] != ']')) {
+            return false;
+        }
+
+        // the first character decides: the literal is scanned once, either as IPvFuture or as IPv6
+        auto address = host.substr(1, host.size() - 2);
+        if ((address[0] == 'v') || (address[0] == 'V')) {
+            if (IsIPvFuture(address)) {
+                host_address.type_ = HostType::kIPvFuture;
+                return true;
+            }
+            return false;
+        }
+        if (ParseIPv6(address, host_address.ipv6_)) {
+            host_address.type_ = HostType::kIPv6;
+            return true;
+        }
+        host_address.ipv6_.fill(0);
+        return false;
+    }
+
+    if (ParseIPv4(host, host_address.ipv4_)) {
+        host_address.type_ = HostType::kIPv4;
+        return true;
+    }
+
+    if (IsRegName(host)) {
+        host_address.type_ = HostType::kRegName;
+        return true;
+    }
+
+    return false;
+}
+
+
 /**
  * @brief   Checks if the given host is valid.
  * @param   host                the host to check.
  * @return  true, if it is.
  */
 inline bool IsValidHost(std::string_view const & host) {
-    if (host.find_first_of('[') != std::string_view::npos) {
-        return IsIPLiteral(host);
+    HostAddress host_address;
+    return ParseHost(host, host_address);
+}
+
+
+/**
+ * @brief   Identifies the type and binary address of a host known to be valid.
+ * Unlike ParseHost() the characters of a reg-name are not checked.
+ * @param   host                the host to classify.
+ * @param   host_address        the type and binary address of the host.
+ */
+inline void ClassifyHost(std::string_view const & host, HostAddress & host_address) {
+
+    host_address = HostAddress{};
+    if ((host.size() >= 3) && (host[0] == '[')) {
+        auto address = host.substr(1, host.size() - 2);
+        if ((address[0] == 'v') || (address[0] == 'V')) {
+            host_address.type_ = HostType::kIPvFuture;
+        } else {
+            ParseIPv6(address, host_address.ipv6_);
+            host_address.type_ = HostType::kIPv6;
+        }
+        return;
+    }
+
+    host_address.type_ = ParseIPv4(host, host_address.ipv4_) ? HostType::kIPv4 : HostType::kRegName;
+}
+
+
+/**
+ * @brief   Parses the given port into a number.
+ * @param   port                the port to parse.
+ * @param   port_number         the parsed port number (0 for an empty port).
+ * @return  true, if the port is valid.
+ */
+inline bool ParsePortNumber(std::string_view const & port, std::uint16_t & port_number) {
+
+    // The RFC allows any number of digits, but TCP and UDP ports are limited to 16 bit.
+    std::uint32_t value{0};
+    for (auto c : port) {
+        if (!IsDigit(c)) {
+            return false;
+        }
+        value = value * 10 + (c - '0');
+        if (value > 0xffff) {
+            return false;
+        }
     }
-    return IsIPv4(host) || IsRegName(host);
+
+    port_number = static_cast<std::uint16_t>(value);
+    return true;
 }
 
 
@@ -349,7 +584,8 @@ inline bool IsValidHost(std::string_view const & host) {
  * @return  true, if it is.
  */
 inline bool IsValidPort(std::string_view const & port) {
-    return std::all_of(port.cbegin(), port.cend(), [](char c) { return IsDigit(c); });
+    std::uint16_t port_number;
+    return ParsePortNumber(port, port_number);
 }
 
 
@@ -367,7 +603,7 @@ inline bool IsValidPathSegment(std::string_view const & segment) {
         }
 
         // pct-encoded
-        if (segment[i] == '%' && i < (segment.size() - 2) && IsHexDigit(segment[i + 1]) && IsHexDigit(segment[i + 2])) {
+        if (segment[i] == '%' && (i + 2) < segment.size() && IsHexDigit(segment[i + 1]) && IsHexDigit(segment[i + 2])) {
             i += 2;
             continue;
         }
@@ -408,7 +644,7 @@ inline bool IsValidUserInfo(std::string_view const & userinfo) {
         }
 
         // pct-encoded
-        if (userinfo[i] == '%' && i < (userinfo.size() - 2) && IsHexDigit(userinfo[i + 1]) &&
+        if (userinfo[i] == '%' && (i + 2) < userinfo.size() && IsHexDigit(userinfo[i + 1]) &&
             IsHexDigit(userinfo[i + 2])) {
             i += 2;
             continue;
@@ -427,220 +663,406 @@ inline bool IsValidUserInfo(std::string_view const & userinfo) {
  * @return  lower case c (or c if c not in range).
  */
 inline char ToLower(char c) {
-    if ((c >= 'A') && (c < 'Z')) {
+    if ((c >= 'A') && (c <= 'Z')) {
         c += 0x20;
     }
     return c;
 }
 
 
+#ifdef HEADCODE_SPACE_URL_SSE2
+
 /**
- * @brief   Convert ASCII range a..z to upper case.
- * @param   c       the character to convert.
- * @return  upper case c (or c if c not in range).
+ * @brief   Converts 16 ASCII characters A..Z to lower case at once.
+ * @param   v       the characters to convert.
+ * @return  v in lower case (bytes >= 0x80 are negative and never in range).
  */
-inline char ToUpper(char c) {
-    if ((c >= 'a') && (c < 'z')) {
-        c -= 0x20;
-    }
-    return c;
+inline __m128i ToLower16(__m128i v) {
+    auto upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
 }
 
+#endif
+
 
 /**
- * @brief   Normalizes a percent encoded part of an URL.
- * @param   percent_encoded     an percent encoded particle.
- * @return  A string holding the percent encoded value (or upper case percent encoded).
+ * @brief   Copies characters converting ASCII A..Z to lower case.
+ *
+ * With SSE2 16 characters are converted per step, the tail one by one.
+ * The source and destination may be the same (converting in place).
+ *
+ * @param   destination     the destination of the copy.
+ * @param   source          the characters to copy.
+ * @param   size            the number of characters.
  */
-inline std::string NormalizePercentEncoded(std::string_view const & percent_encoded) {
+inline void CopyLower(char * destination, char const * source, std::size_t size) {
 
-    if ((percent_encoded.size() < 3) || (percent_encoded[0] != '%')) {
-        return std::string{};
+    std::size_t i{0};
+#ifdef HEADCODE_SPACE_URL_SSE2
+    for (; i + 16 <= size; i += 16) {
+        auto v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), ToLower16(v));
     }
-
-    char v1 = percent_encoded[1];
-    char v2 = percent_encoded[2];
-    if (!IsHexDigit(v1) && !IsHexDigit(v2)) {
-        return std::string{};
+#endif
+    for (; i < size; ++i) {
+        destination[i] = ToLower(source[i]);
     }
-    v1 = ToUpper(v1);
-    v2 = ToUpper(v2);
-
-    std::stringstream ss;
-    ss << "%" << v1 << v2;
-    char value = (IsDigit(v1) ? v1 - '0' : (v1 - 'A' + 0x0a)) << 4;
-    value |= IsDigit(v2) ? v2 - '0' : (v2 - 'A' + 0x0a);
+}
 
-    if (IsUnreserved(value)) {
-        return std::string{value};
-    }
 
-    return ss.str();
+/**
+ * @brief   Appends a string in lower case (ASCII A..Z only).
+ * @param   out     the string to append to.
+ * @param   s       the string to append.
+ */
+inline void AppendLower(std::string & out, std::string_view const & s) {
+    auto start = out.size();
+    out.resize(start + s.size());
+    CopyLower(out.data() + start, s.data(), s.size());
 }
 
 
 /**
- * @brief   Normalizes the authority part of an URL.
- * @param   authority       the authority to normalize.
- * @return  A string holding the normalized authority.
+ * @brief   Checks if two strings are equal ignoring the case of ASCII letters.
+ *
+ * With SSE2 16 characters are compared per step, the tail one by one.
+ *
+ * @param   lhs     left hand side string.
+ * @param   rhs     right hand side string.
+ * @return  true, if both strings are equal (ignoring case).
  */
-inline std::string NormalizeAuthority(std::string_view const & authority) {
+inline bool EqualsIgnoreCase(std::string_view const & lhs, std::string_view const & rhs) {
 
-    std::stringstream ss;
-
-    for (std::size_t i = 0; i < authority.size(); ++i) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
 
-        // pct-encoded
-        if (authority[i] == '%' && i < (authority.size() - 2) && IsHexDigit(authority[i + 1]) &&
-            IsHexDigit(authority[i + 2])) {
-            ss << NormalizePercentEncoded(authority.substr(i, 3));
-            i += 2;
-            continue;
+    std::size_t i{0};
+#ifdef HEADCODE_SPACE_URL_SSE2
+    for (; i + 16 <= lhs.size(); i += 16) {
+        auto l = ToLower16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs.data() + i)));
+        auto r = ToLower16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs.data() + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(l, r)) != 0xffff) {
+            return false;
+        }
+    }
+#endif
+    for (; i < lhs.size(); ++i) {
+        if (ToLower(lhs[i]) != ToLower(rhs[i])) {
+            return false;
         }
-
-        ss << ToLower(authority[i]);
     }
 
-    return ss.str();
+    return true;
 }
 
 
 /**
- * @brief   Normalizes the fragment part of an URL
- * @param   fragment        the fragment to normalize.
- * @return  A string holding the normalized fragment.
+ * @brief   Known default ports of schemes.
  */
-inline std::string NormalizeFragment(std::string_view const & fragment) {
-    // fragments remain unchanged
-    return std::string{fragment};
-}
+constexpr std::array<std::pair<std::string_view, std::uint16_t>, 15> kDefaultPorts{{{"ftp", 21},
+                                                                                    {"gopher", 70},
+                                                                                    {"http", 80},
+                                                                                    {"https", 443},
+                                                                                    {"imap", 143},
+                                                                                    {"ldap", 389},
+                                                                                    {"ldaps", 636},
+                                                                                    {"nntp", 119},
+                                                                                    {"pop", 110},
+                                                                                    {"rtsp", 554},
+                                                                                    {"sftp", 22},
+                                                                                    {"ssh", 22},
+                                                                                    {"telnet", 23},
+                                                                                    {"ws", 80},
+                                                                                    {"wss", 443}}};
 
 
 /**
- * @brief   Normalizes the path part of an URL
- * @param   segments            the path to normalize.
- * @return  A string holding the normalized path.
+ * @brief   Identifies a well known scheme.
+ * @param   scheme      the scheme (case-insensitive).
+ * @return  The kind of scheme or SchemeKind::kUnknown.
  */
-inline std::string NormalizePath(std::vector<std::string_view> const & segments) {
+inline SchemeKind ClassifyScheme(std::string_view const & scheme) {
+
+    // Strategy: switch on length and first character, then
+    // confirm the single candidate left.
+
+    if (scheme.empty()) {
+        return SchemeKind::kUnknown;
+    }
 
-    std::vector<std::string_view> path;
+    SchemeKind candidate{SchemeKind::kUnknown};
+    char first = ToLower(scheme[0]);
+    switch (scheme.size()) {
 
-    std::size_t pos = 0;
-    for (auto const & segment : segments) {
+        case 2:
+            candidate = (first == 'w') ? SchemeKind::kWs : SchemeKind::kUnknown;
+            break;
 
-        if (segment == "..") {
-            if (pos > 0) {
-                --pos;
+        case 3:
+            if (first == 'f') {
+                candidate = SchemeKind::kFtp;
+            } else if (first == 'w') {
+                candidate = SchemeKind::kWss;
             }
-            continue;
-        }
+            break;
+
+        case 4:
+            if (first == 'h') {
+                candidate = SchemeKind::kHttp;
+            } else if (first == 'f') {
+                candidate = SchemeKind::kFile;
+            } else if (first == 'd') {
+                candidate = SchemeKind::kData;
+            }
+            break;
 
-        if (segment == ".") {
-            continue;
-        }
+        case 5:
+            candidate = (first == 'h') ? SchemeKind::kHttps : SchemeKind::kUnknown;
+            break;
 
-        if (pos < path.size()) {
-            path[pos] = segment;
-        } else {
-            path.emplace_back(segment);
-        }
-        ++pos;
+        case 6:
+            candidate = (first == 'm') ? SchemeKind::kMailto : SchemeKind::kUnknown;
+            break;
     }
-    path.resize(pos);
 
-    std::stringstream ss;
-    if (!path.empty()) {
-        auto iter = path.cbegin();
-        ss << *iter++;
-        for (; iter != path.cend(); ++iter) {
-            ss << '/' << *iter;
-        }
+    static constexpr std::array<std::string_view, 9> names{
+            "", "data", "file", "ftp", "http", "https", "mailto", "ws", "wss"};
+    if ((candidate != SchemeKind::kUnknown) && EqualsIgnoreCase(scheme, names[static_cast<std::size_t>(candidate)])) {
+        return candidate;
     }
 
-    return ss.str();
+    return SchemeKind::kUnknown;
 }
 
 
 /**
- * @brief   Normalizes the query part of an URL
- * @param   query           the query to normalize.
- * @return  A string holding the normalized query.
+ * @brief   Returns the default port of a well known scheme.
+ * @param   scheme_kind     the kind of scheme.
+ * @return  The default port of the scheme or 0 if none.
  */
-inline std::string NormalizeQuery(std::string_view const & query) {
-    // queries should remain untouched
-    return std::string{query};
+constexpr std::uint16_t GetDefaultPort(SchemeKind scheme_kind) {
+
+    switch (scheme_kind) {
+        case SchemeKind::kFtp:
+            return 21;
+        case SchemeKind::kHttp:
+        case SchemeKind::kWs:
+            return 80;
+        case SchemeKind::kHttps:
+        case SchemeKind::kWss:
+            return 443;
+        default:
+            return 0;
+    }
 }
 
 
 /**
- * @brief   Normalizes the scheme part of an URL
- * @param   scheme          the scheme to normalize.
- * @return  A string holding the normalized scheme.
+ * @brief   Returns the default port of a scheme.
+ * @param   scheme      the scheme (case-insensitive).
+ * @return  The default port of the scheme or 0 if unknown.
  */
-inline std::string NormalizeScheme(std::string_view const & scheme) {
-    std::string res{scheme};
-    std::transform(res.begin(), res.end(), res.begin(), [](char c) { return ToLower(c); });
-    return res;
+inline std::uint16_t GetDefaultPort(std::string_view const & scheme) {
+    for (auto const & [name, port] : kDefaultPorts) {
+        if (EqualsIgnoreCase(name, scheme)) {
+            return port;
+        }
+    }
+    return 0;
 }
 
 
 /**
- * @brief   Parse the port part inside an authority string.
- * @param   authority       the authority to parse.
- * @param   port            the start and length of the port value found in the authority.
- * @return  ParseError value.
+ * @brief   Convert ASCII range a..z to upper case.
+ * @param   c       the character to convert.
+ * @return  upper case c (or c if c not in range).
  */
-inline ParseError ParsePort(std::string_view const & authority, std::pair<std::size_t, std::size_t> & port) {
-
-    port = std::make_pair(0, 0);
-    if (authority.empty()) {
-        return ParseError::kNoError;
+inline char ToUpper(char c) {
+    if ((c >= 'a') && (c <= 'z')) {
+        c -= 0x20;
     }
+    return c;
+}
 
-    // Some special treatment since a colon ':' may also appear inside
-    // the IPLiteral (IPv6 and IPvFuture) of the authority. Luckily those
-    // IPLiterals are placed inside '[' and ']'.
-    auto port_part = authority;
-    auto closing_ipliteral_bracket = authority.find_last_of(']');
-    if (closing_ipliteral_bracket != std::string::npos) {
-        port_part = authority.substr(closing_ipliteral_bracket + 1);
-    }
-    auto port_pos = port_part.find_last_of(':');
-    if (port_pos != std::string::npos) {
-        port = std::make_pair(port_pos + 1, authority.size() - (port_pos + 1));
+
+/**
+ * @brief   Appends the normalized form of a percent encoded triplet (RFC 3986 6.2.2.2).
+ * @param   out         the string to append to.
+ * @param   v1          the first hex digit.
+ * @param   v2          the second hex digit.
+ */
+inline void AppendPercentEncoded(std::string & out, char v1, char v2) {
+
+    char value = static_cast<char>((HexDigitValue(v1) << 4) | HexDigitValue(v2));
+    if (IsUnreserved(value)) {
+        out.push_back(value);
+        return;
     }
 
-    return ParseError::kNoError;
+    char triplet[] = {'%', ToUpper(v1), ToUpper(v2)};
+    out.append(triplet, sizeof(triplet));
 }
 
 
 /**
- * @brief   Parse the authority in the URL beginning at start.
- * @param   url             the url to parse.
- * @param   start           start of authority part in url
- * @param   authority       the (full) authority to write
- * @param   userinfo        the userinfo to write
- * @param   host            the host to write
- * @param   port            the port to write
- * @return  ParseError value and end position of parsing (i.e. ':' or end).
+ * @brief   Appends a part of an URL with all percent encodings normalized (RFC 3986 6.2.2.2).
+ *
+ * The '%' are searched with memchr(), which is vectorized by the C library:
+ * runs without a percent encoding (the common case) are appended as a block.
+ *
+ * @param   out         the string to append to.
+ * @param   part        the part of the URL (path segment, query or fragment).
  */
-inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string_view const & url,
-                                                                     std::size_t start,
-                                                                     std::pair<std::size_t, std::size_t> & authority,
-                                                                     std::pair<std::size_t, std::size_t> & userinfo,
-                                                                     std::pair<std::size_t, std::size_t> & host,
-                                                                     std::pair<std::size_t, std::size_t> & port) {
+inline void AppendPercentNormalized(std::string & out, std::string_view part) {
 
-    // Strategy: Identify the portion of the authority inside the URL.
-    // Then detect the port, if any. Afterwards split the remaining part
-    // in user info and host.
+    while (!part.empty()) {
+
+        auto percent = static_cast<char const *>(std::memchr(part.data(), '%', part.size()));
+        if (percent == nullptr) {
+            out.append(part);
+            return;
+        }
+
+        auto run = static_cast<std::size_t>(percent - part.data());
+        out.append(part.data(), run);
+        part.remove_prefix(run);
+
+        if ((part.size() >= 3) && IsHexDigit(part[1]) && IsHexDigit(part[2])) {
+            AppendPercentEncoded(out, part[1], part[2]);
+            part.remove_prefix(3);
+        } else {
+            out.push_back('%');
+            part.remove_prefix(1);
+        }
+    }
+}
+
+
+/**
+ * @brief   Appends the normalized authority part of an URL.
+ *
+ * Like AppendPercentNormalized() but the runs between the percent encodings
+ * are lower case copied as a block.
+ *
+ * @param   out             the string to append to.
+ * @param   authority       the authority to normalize.
+ */
+inline void AppendNormalizedAuthority(std::string & out, std::string_view authority) {
+
+    while (!authority.empty()) {
+
+        auto percent = static_cast<char const *>(std::memchr(authority.data(), '%', authority.size()));
+        auto run = (percent == nullptr) ? authority.size() : static_cast<std::size_t>(percent - authority.data());
+        AppendLower(out, authority.substr(0, run));
+        authority.remove_prefix(run);
+
+        if ((authority.size() >= 3) && IsHexDigit(authority[1]) && IsHexDigit(authority[2])) {
+            AppendPercentEncoded(out, authority[1], authority[2]);
+            authority.remove_prefix(3);
+        } else if (!authority.empty()) {
+            out.push_back('%');
+            authority.remove_prefix(1);
+        }
+    }
+}
+
+
+/**
+ * @brief   Appends the normalized path of an URL.
+ *
+ * The path is percent normalized forward into out first (so "%2E" is a '.')
+ * and then the dot segments are removed in place right there. A rootless
+ * path is handled as absolute path and stays rootless.
+ *
+ * @param   out         the string to append to.
+ * @param   path        the path to normalize.
+ */
+inline void AppendNormalizedPath(std::string & out, std::string_view const & path) {
+
+    auto start = out.size();
+    bool rootless = !path.empty() && (path[0] != '/');
+    if (rootless) {
+        out.push_back('/');
+    }
+    AppendPercentNormalized(out, path);
+
+    auto size = headcode::url::RemoveDotSegments(out.data() + start, out.size() - start);
+    out.resize(start + size);
+    if (rootless) {
+        out.erase(start, 1);
+    }
+}
+
+
+/**
+ * @brief   Parse the port part inside an authority string.
+ * @param   authority       the authority to parse.
+ * @param   port            the start and length of the port value found in the authority.
+ * @return  ParseError value.
+ */
+inline ParseError ParsePort(std::string_view const & authority, std::pair<std::size_t, std::size_t> & port) {
+
+    port = std::make_pair(0, 0);
+    if (authority.empty()) {
+        return ParseError::kNoError;
+    }
+
+    // Some special treatment since a colon ':' may also appear inside
+    // the IPLiteral (IPv6 and IPvFuture) of the authority. Luckily those
+    // IPLiterals are placed inside '[' and ']'.
+    std::size_t port_part_start{0};
+    auto closing_ipliteral_bracket = authority.find_last_of(']');
+    if (closing_ipliteral_bracket != std::string::npos) {
+        port_part_start = closing_ipliteral_bracket + 1;
+    }
+    auto port_pos = authority.substr(port_part_start).find_last_of(':');
+    if (port_pos != std::string::npos) {
+        port_pos += port_part_start;
+        port = std::make_pair(port_pos + 1, authority.size() - (port_pos + 1));
+    }
+
+    return ParseError::kNoError;
+}
+
+
+/**
+ * @brief   Parse the authority in the URL beginning at start.
+ * @param   url             the url to parse.
+ * @param   start           start of authority part in url
+ * @param   authority       the (full) authority to write
+ * @param   userinfo        the userinfo to write
+ * @param   host            the host to write
+ * @param   host_address    the type and binary address of the host to write
+ * @param   port            the port to write
+ * @param   port_number     the numeric value of the port to write
+ * @param   validate_userinfo   check the characters of the userinfo
+ * @return  ParseError value and end position of parsing (i.e. ':' or end).
+ * @tparam  Validate        check the characters of userinfo and host (else only locate them).
+ */
+template <bool Validate = true>
+inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string_view const & url,
+                                                                     std::size_t start,
+                                                                     std::pair<std::size_t, std::size_t> & authority,
+                                                                     std::pair<std::size_t, std::size_t> & userinfo,
+                                                                     std::pair<std::size_t, std::size_t> & host,
+                                                                     HostAddress & host_address,
+                                                                     std::pair<std::size_t, std::size_t> & port,
+                                                                     std::uint16_t & port_number,
+                                                                     bool validate_userinfo = true) {
+
+    // Strategy: Identify the portion of the authority inside the URL.
+    // Then detect the port, if any. Afterwards split the remaining part
+    // in user info and host.
     // If all strings have been identified, make a check on each for
     // validity (i.e. not containing illegal characters).
 
     authority = std::make_pair(start, 0);
     userinfo = std::make_pair(start, 0);
     host = std::make_pair(start, 0);
+    host_address = HostAddress{HostType::kRegName};
     port = std::make_pair(start, 0);
+    port_number = 0;
     if (url.empty()) {
         return {ParseError::kNoError, url.size()};
     }
@@ -658,6 +1080,7 @@ inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string
     last += start;
 
     ParseError error = ParsePort(url.substr(authority.first, authority.second), port);
+    bool port_present = port.first > 0;        // port (if any) starts after the ':'
     port.first += start;
     if (error != ParseError::kNoError) {
         return {error, port.first + port.second};
@@ -667,7 +1090,7 @@ inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string
     // To here: port identified done.
 
     auto host_part = url.substr(start, last - start);
-    if (port.second) {
+    if (port_present) {
         host.second = host.second - 1 - port.second;
         host_part = url.substr(host.first, host.second);
     }
@@ -687,19 +1110,23 @@ inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string
 
     // To here: separated user info and host part.
 
-    if (!IsValidUserInfo(userinfo_part)) {
-        error = ParseError::kInvalidUserInfo;
-    }
-    if ((error == ParseError::kNoError) && !IsValidHost(host_part)) {
-        error = ParseError::kInvalidHost;
+    if constexpr (Validate) {
+        if (validate_userinfo && !IsValidUserInfo(userinfo_part)) {
+            error = ParseError::kInvalidUserInfo;
+        }
+        if ((error == ParseError::kNoError) && !ParseHost(host_part, host_address)) {
+            error = ParseError::kInvalidHost;
+        }
+    } else {
+        ClassifyHost(host_part, host_address);
     }
-    if (IsIPLiteral(host_part)) {
+    if ((host_address.type_ == HostType::kIPv6) || (host_address.type_ == HostType::kIPvFuture)) {
         // IPLiterals are enclosed in '[' and ']' --> omit them in the pure host value
         host.first++;
-        host.second = host_part.find_first_of(']') - 1;
+        host.second -= 2;
     }
 
-    if ((error == ParseError::kNoError) && !IsValidPort(port_part)) {
+    if ((error == ParseError::kNoError) && !ParsePortNumber(port_part, port_number)) {
         error = ParseError::kInvalidPort;
     }
 
@@ -713,80 +1140,132 @@ inline std::tuple<ParseError, std::string::size_type> ParseAuthority(std::string
  * @param   start       the start index of the query in url.
  * @param   fragment    the identified fragment start and length in url.
  * @return  ParseError value and end position of parsing.
+ * @tparam  Validate    check the characters of the fragment.
  */
+template <bool Validate = true>
 inline std::tuple<ParseError, std::string::size_type> ParseFragment(std::string_view const & url,
                                                                     std::size_t start,
                                                                     std::pair<std::size_t, std::size_t> & fragment) {
     auto last = url.size();
     fragment = std::make_pair(start, last - start);
-    if (!IsValidFragment(url.substr(fragment.first, fragment.second))) {
-        return {ParseError::kInvalidFragment, last};
+    if constexpr (Validate) {
+        if (!IsValidFragment(url.substr(fragment.first, fragment.second))) {
+            return {ParseError::kInvalidFragment, last};
+        }
     }
 
     return {ParseError::kNoError, last};
 }
 
 
+/**
+ * @brief   Checks if a character at a position in the url continues a pct-encoded value.
+ * @param   url         the url.
+ * @param   i           position of the '%'.
+ * @return  true, if url[i] starts a valid pct-encoded value.
+ */
+inline bool IsPercentEncodedAt(std::string_view const & url, std::size_t i) {
+    return (url[i] == '%') && ((i + 2) < url.size()) && IsHexDigit(url[i + 1]) && IsHexDigit(url[i + 2]);
+}
+
+
+/**
+ * @brief   Adds the last item of a split to the list of items.
+ * Like the items before a trailing empty item is dropped (e.g. "a/" holds only "a")
+ * unless it is the only item (e.g. "/" holds a single empty segment).
+ * @param   items           the items found so far.
+ * @param   start           start of the last item.
+ * @param   end             end of the last item.
+ */
+template <typename Offsets>
+inline void AddLastItem(Offsets & items, std::size_t start, std::size_t end) {
+    if ((end > start) || items.empty()) {
+        items.emplace_back(start, end - start);
+    }
+}
+
+
 /**
  * @brief   Parse the path of the url and provide each segment.
  * @param   url                 the url to parse.
  * @param   start               start of path part in url.
  * @param   authority_present   flag indicating that we have an authority
  * @param   path                the path parsed.
- * @param   segments            vector of segments found.
+ * @param   segments            vector of segments found (or an OffsetCounter).
+ * @param   max_segments        maximum number of segments allowed.
  * @return  ParseError value and end position of parsing (i.e. '?' or '#' or end).
+ * @tparam  Validate            check the characters of the segments (else only split).
  */
+template <bool Validate = true, typename Offsets>
 inline std::tuple<ParseError, std::string::size_type> ParsePath(
         std::string_view const & url,
         std::size_t start,
         bool authority_present,
         std::pair<std::size_t, std::size_t> & path,
-        std::vector<std::pair<std::size_t, std::size_t>> & segments) {
+        Offsets & segments,
+        std::size_t max_segments = static_cast<std::size_t>(-1)) {
 
-    // Strategy: split path by '/' and collect each segment.
-    // However, there are a number of special cases in the RFC to treat.
+    // Strategy: a single pass over the path, splitting the segments at '/' and
+    // validating each character on the fly. After an invalid character we only
+    // look for the end of the path. Every character is visited once.
 
     segments.clear();
     path = std::make_pair(start, 0);
-    auto path_part = url.substr(start);
-    auto last = path_part.find_first_of("?#");
-    if (last != std::string_view::npos) {
-        path_part = url.substr(start, last);
-    }
-    path.second = path_part.size();
-    last += start;
 
-    bool is_absolute = !path_part.empty() && (path_part[0] == '/');
-    bool is_absolute_or_empty = is_absolute || path_part.empty();
-    if (authority_present && !is_absolute_or_empty) {
-        return {ParseError::kInvalidPath, path.second + start};
-    }
+    bool is_absolute = (start < url.size()) && (url[start] == '/');
+    std::size_t i = is_absolute ? start + 1 : start;
+    std::size_t segment_start = i;
+    bool valid{true};
 
-    if (path_part.empty()) {
-        return {ParseError::kNoError, last};
-    }
+    for (; i < url.size(); ++i) {
 
-    // To here: path seems ok so far w.r.t. RFC. --> split the path in segments.
+        char c = url[i];
+        if ((c == '?') || (c == '#')) {
+            break;
+        }
 
-    std::string_view::size_type i = path_part[0] == '/' ? 1 : 0;
-    auto nibbled_path = path_part.substr(i);
-    do {
+        if (c == '/') {
+            if (segments.size() == max_segments) {
+                return {ParseError::kTooManySegments, i};
+            }
+            segments.emplace_back(segment_start, i - segment_start);
+            segment_start = i + 1;
+            continue;
+        }
 
-        auto segment_part = nibbled_path.substr(0, nibbled_path.find_first_of('/'));
-        segments.emplace_back(start + i, segment_part.size());
+        if constexpr (Validate) {
+            if (IsUnreserved(c) || IsSubDelimiter(c) || (c == ':') || (c == '@')) {
+                continue;
+            }
+            if (IsPercentEncodedAt(url, i)) {
+                i += 2;
+                continue;
+            }
 
-        if (!IsValidPathSegment(segment_part)) {
-            return {ParseError::kInvalidPath, path.first + path.second};
+            valid = false;
+            i = std::min(url.find_first_of("?#", i), url.size());
+            break;
         }
+    }
+    path.second = i - start;
 
-        i += segment_part.size() + 1;
-        if (i < path_part.size()) {
-            nibbled_path = path_part.substr(i);
-        }
+    if (path.second == 0) {
+        return {ParseError::kNoError, i};
+    }
+    if (authority_present && !is_absolute) {
+        segments.clear();
+        return {ParseError::kInvalidPath, i};
+    }
+    if (!valid) {
+        return {ParseError::kInvalidPath, i};
+    }
 
-    } while (i < path_part.size());
+    if (((i > segment_start) || segments.empty()) && (segments.size() == max_segments)) {
+        return {ParseError::kTooManySegments, i};
+    }
+    AddLastItem(segments, segment_start, i);
 
-    return {ParseError::kNoError, last};
+    return {ParseError::kNoError, i};
 }
 
 
@@ -795,42 +1274,75 @@ inline std::tuple<ParseError, std::string::size_type> ParsePath(
  * @param   url             the url to parse, beginning at the scheme.
  * @param   start           the start index of the query in url.
  * @param   query           the identified query start and length in url.
- * @param   query_items     the identified separated query items in url.
+ * @param   query_items     the identified separated query items in url (or an OffsetCounter).
+ * @param   max_query_items maximum number of query items allowed.
  * @return  ParseError value and end position of parsing.
+ * @tparam  Validate        check the characters of the query (else only split).
  */
+template <bool Validate = true, typename Offsets>
 inline std::tuple<ParseError, std::string::size_type> ParseQuery(
         std::string_view const & url,
         std::size_t start,
         std::pair<std::size_t, std::size_t> & query,
-        std::vector<std::pair<std::size_t, std::size_t>> & query_items) {
+        Offsets & query_items,
+        std::size_t max_query_items = static_cast<std::size_t>(-1)) {
 
-    auto last = url.substr(start).find_first_of('#');
-    if (last == std::string_view::npos) {
-        last = url.size() - start;
-    }
-    query = std::make_pair(start, last);
-    last += start;
+    // Strategy: a single pass over the query, splitting the items at '&' and
+    // validating each character on the fly (same rules as for fragments).
 
-    auto query_part = url.substr(query.first, query.second);
-    if (!IsValidQuery(query_part)) {
-        return {ParseError::kInvalidQuery, last};
-    }
+    query = std::make_pair(start, 0);
 
-    std::size_t i{0};
-    auto nibbled_query = query_part;
-    do {
+    std::size_t i = start;
+    std::size_t item_start = start;
+    bool valid{true};
 
-        auto query_item_part = nibbled_query.substr(0, nibbled_query.find_first_of('&'));
-        query_items.emplace_back(start + i, query_item_part.size());
+    for (; i < url.size(); ++i) {
 
-        i += query_item_part.size() + 1;
-        if (i < nibbled_query.size()) {
-            nibbled_query = query_part.substr(i);
+        char c = url[i];
+        if (c == '#') {
+            break;
         }
 
-    } while (i < query_part.size());
+        if (c == '&') {
+            if (query_items.size() == max_query_items) {
+                return {ParseError::kTooManyQueryItems, i};
+            }
+            query_items.emplace_back(item_start, i - item_start);
+            item_start = i + 1;
+            continue;
+        }
 
-    return {ParseError::kNoError, last};
+        if constexpr (Validate) {
+            if (IsUnreserved(c) || IsSubDelimiter(c) || (c == ':') || (c == '@') || (c == '/') || (c == '?')) {
+                continue;
+            }
+            if (IsPercentEncodedAt(url, i)) {
+                i += 2;
+                continue;
+            }
+
+            valid = false;
+            i = std::min(url.find_first_of('#', i), url.size());
+            break;
+        }
+    }
+    query.second = i - start;
+
+    if (!valid) {
+        query_items.clear();
+        return {ParseError::kInvalidQuery, i};
+    }
+
+    // an empty query has no items (wherever it ends)
+    if (query.second == 0) {
+        return {ParseError::kNoError, i};
+    }
+    if (((i > item_start) || query_items.empty()) && (query_items.size() == max_query_items)) {
+        return {ParseError::kTooManyQueryItems, i};
+    }
+    AddLastItem(query_items, item_start, i);
+
+    return {ParseError::kNoError, i};
 }
 
 
@@ -839,13 +1351,16 @@ inline std::tuple<ParseError, std::string::size_type> ParseQuery(
  * @param   url         the url to parse, beginning at the scheme.
  * @param   start       the start index of the scheme in url.
  * @param   scheme      the identified scheme start and length in url.
+ * @param   scheme_kind the identified well known scheme.
  * @return  ParseError value and end position of parsing (i.e. ':' or end).
  */
 inline std::tuple<ParseError, std::string::size_type> ParseScheme(std::string_view const & url,
                                                                   std::size_t start,
-                                                                  std::pair<std::size_t, std::size_t> & scheme) {
+                                                                  std::pair<std::size_t, std::size_t> & scheme,
+                                                                  SchemeKind & scheme_kind) {
 
     scheme = std::make_pair(0, 0);
+    scheme_kind = SchemeKind::kUnknown;
     auto scheme_string = url.substr(start);
     if (scheme_string.empty()) {
         return {ParseError::kEmptyScheme, url.size()};
@@ -860,6 +1375,7 @@ inline std::tuple<ParseError, std::string::size_type> ParseScheme(std::string_vi
         if (!IsSchemeChar(url[pos])) {
             if (url[pos] == ':') {
                 scheme.second = pos;
+                scheme_kind = ClassifyScheme(url.substr(start, pos - start));
                 return {ParseError::kNoError, pos};
             }
             return {ParseError::kInvalidSchemeChar, pos};
@@ -874,52 +1390,634 @@ inline std::tuple<ParseError, std::string::size_type> ParseScheme(std::string_vi
 }
 
 
-inline headcode::url::URL headcode::url::URL::Normalize() const {
+inline std::size_t headcode::url::RemoveDotSegments(char * path, std::size_t size) {
+
+    // Strategy: the RFC 3986 5.2.4 loop with a read and a write position. The
+    // output buffer is path[0, write) and never overtakes the input buffer
+    // path[read, size): a rule which replaces a prefix of the input with "/"
+    // writes that '/' right in front of the remaining input.
+
+    std::size_t read{0};
+    std::size_t write{0};
+    auto input = [&]() { return std::string_view{path + read, size - read}; };
+    auto pop_output = [&]() {
+        while ((write > 0) && (path[write - 1] != '/')) {
+            --write;
+        }
+        if (write > 0) {
+            --write;
+        }
+    };
+
+    while (read < size) {
+
+        auto rest = input();
+        if (rest.substr(0, 3) == "../") {
+            read += 3;
+        } else if (rest.substr(0, 2) == "./") {
+            read += 2;
+        } else if (rest.substr(0, 3) == "/./") {
+            read += 2;
+        } else if (rest == "/.") {
+            read += 1;
+            path[read] = '/';
+        } else if (rest.substr(0, 4) == "/../") {
+            read += 3;
+            pop_output();
+        } else if (rest == "/..") {
+            read += 2;
+            path[read] = '/';
+            pop_output();
+        } else if ((rest == ".") || (rest == "..")) {
+            read = size;
+        } else {
+            // move the first segment (with its leading '/') to the output
+            auto end = rest.find('/', 1);
+            auto length = (end == std::string_view::npos) ? rest.size() : end;
+            std::copy(path + read, path + read + length, path + write);
+            read += length;
+            write += length;
+        }
+    }
+
+    return write;
+}
+
+
+inline void headcode::url::RemoveDotSegments(std::string & path) {
+    path.resize(RemoveDotSegments(path.data(), path.size()));
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURL<Policy>::Assign(std::string_view url, ParseLimits const & limits) {
+    url_.assign(url.data(), url.size());
+    Reset();
+    Parse(limits);
+}
+
+
+template <typename Policy>
+inline std::uint16_t headcode::url::BasicURL<Policy>::GetEffectivePort() const {
+    if (port_.second > 0) {
+        return port_number_;
+    }
+    if (scheme_kind_ != SchemeKind::kUnknown) {
+        return impl::GetDefaultPort(scheme_kind_);
+    }
+    return impl::GetDefaultPort(GetScheme());
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::IsHost(std::string_view host) const {
+    return impl::EqualsIgnoreCase(GetHost(), host);
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::IsScheme(std::string_view scheme) const {
+    return impl::EqualsIgnoreCase(GetScheme(), scheme);
+}
+
+
+template <typename Policy>
+inline headcode::url::BasicURL<Policy> headcode::url::BasicURL<Policy>::Normalize() const {
 
     if (url_.empty()) {
-        return URL{};
+        return BasicURL{};
     }
 
     using namespace headcode::url::impl;
 
-    std::stringstream ss;
+    [[maybe_unused]] StageTimer timer{ParseStage::kNormalize};
+    std::string normalized;
+    normalized.reserve(url_.size());
 
-    ss << NormalizeScheme(GetScheme()) << ":";
+    AppendLower(normalized, GetScheme());
+    normalized.push_back(':');
     if (!GetAuthority().empty()) {
-        ss << "//" << NormalizeAuthority(GetAuthority());
+        normalized.append("//");
+        AppendNormalizedAuthority(normalized, GetAuthority());
     }
 
-    if (IsPathAbsolute()) {
-        ss << '/';
-    }
-    ss << NormalizePath(GetSegments());
+    // the path is normalized straight from the URL: the segments are not needed
+    AppendNormalizedPath(normalized, GetPath());
 
     if (IsQueryPresent()) {
-        ss << '?';
+        normalized.push_back('?');
+        AppendPercentNormalized(normalized, GetQuery());
+    }
+
+    if constexpr (Policy::kStoreFragment) {
+        if (IsFragmentPresent()) {
+            normalized.push_back('#');
+            AppendPercentNormalized(normalized, GetFragment());
+        }
+    }
+
+    return BasicURL{std::move(normalized)};
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::AppendQueryItem(std::string_view item) {
+
+    if (!IsValid() || item.empty() || (item.find('&') != std::string_view::npos) || !impl::IsValidQuery(item)) {
+        return false;
+    }
+    if (!query_present_) {
+        return SetQuery(item);
+    }
+
+    auto query = GetQuery();
+    bool separate = !query.empty() && (query.back() != '&');
+    auto begin = query_.first + query_.second;
+    auto delta = Replace(begin, 0, separate ? std::string{"&"}.append(item) : std::string{item});
+    query_.second += static_cast<std::size_t>(delta);
+    if constexpr (Policy::kSplitQuery) {
+        this->query_items_.emplace_back(begin + (separate ? 1 : 0), item.size());
+    }
+    ShiftComponents(impl::URLComponent::kFragment, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::AppendSegment(std::string_view segment) {
+
+    if (!IsValid() || segment.empty() || !impl::IsValidPathSegment(segment)) {
+        return false;
+    }
+
+    // "/a" + "b" --> "/a/b", "/a/" + "b" --> "/a/b", "/" + "b" --> "/b"
+    auto path = GetPath();
+    bool separate = path.empty() ? HasAuthority() : (path.back() != '/');
+    auto begin = path_.first + path_.second;
+    auto delta = Replace(begin, 0, separate ? std::string{"/"}.append(segment) : std::string{segment});
+    if constexpr (Policy::kSplitSegments) {
+        if ((path_.second == 1) && (url_[path_.first] == '/')) {
+            this->segments_.clear();        // "/" holds a single empty segment
+        }
+        this->segments_.emplace_back(begin + (separate ? 1 : 0), segment.size());
+    }
+    path_.second += static_cast<std::size_t>(delta);
+    ShiftComponents(impl::URLComponent::kQuery, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURL<Policy>::AnchorEmptyComponents(impl::URLComponent from) {
+
+    using impl::URLComponent;
+
+    auto end = std::make_pair(url_.size(), std::size_t{0});
+    if (from <= URLComponent::kAuthority) {
+        authority_ = end;
+        userinfo_ = end;
+        host_ = end;
+        port_ = end;
+    }
+    if (from <= URLComponent::kPath) {
+        path_ = end;
+    }
+    ShiftComponents(URLComponent::kFragment, 0);
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::HasAuthority() const {
+    return (authority_.first >= 2) && (std::string_view{url_}.substr(authority_.first - 2, 2) == "//");
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURL<Policy>::HostBegin() const {
+    bool ip_literal = (host_address_.type_ == HostType::kIPv6) || (host_address_.type_ == HostType::kIPvFuture);
+    return host_.first - (ip_literal ? 1 : 0);
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURL<Policy>::HostEnd() const {
+    bool ip_literal = (host_address_.type_ == HostType::kIPv6) || (host_address_.type_ == HostType::kIPvFuture);
+    return host_.first + host_.second + (ip_literal ? 1 : 0);
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::RemoveFragment() {
+
+    static_assert(Policy::kStoreFragment, "The fragment is not stored with this policy.");
+    if (!IsValid()) {
+        return false;
+    }
+    if (this->fragment_present_) {
+        Replace(this->fragment_.first - 1, this->fragment_.second + 1, std::string_view{});
+        this->fragment_present_ = false;
+        ShiftComponents(impl::URLComponent::kFragment, 0);
+    }
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::RemovePort() {
+
+    if (!IsValid() || !HasAuthority()) {
+        return false;
+    }
+
+    auto begin = HostEnd();
+    auto delta = Replace(begin, authority_.first + authority_.second - begin, std::string_view{});
+    authority_.second += static_cast<std::size_t>(delta);
+    port_ = std::make_pair(begin, 0);
+    port_number_ = 0;
+    ShiftComponents(impl::URLComponent::kPath, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::RemoveQuery() {
+
+    if (!IsValid()) {
+        return false;
+    }
+    if (query_present_) {
+        auto delta = Replace(query_.first - 1, query_.second + 1, std::string_view{});
+        query_present_ = false;
+        if constexpr (Policy::kSplitQuery) {
+            this->query_items_.clear();
+        }
+        ShiftComponents(impl::URLComponent::kFragment, delta);
+    }
+
+    return true;
+}
+
+
+template <typename Policy>
+template <typename Predicate>
+inline std::size_t headcode::url::BasicURL<Policy>::RemoveQueryItems(Predicate && predicate) {
+
+    static_assert(Policy::kSplitQuery, "The query is not split with this policy.");
+    if (!IsValid() || !query_present_) {
+        return 0;
+    }
+
+    // Single pass: the kept items move to the front of the query (they only
+    // move to the left, so a forward copy is safe), then the fragment follows.
+    auto & query_items = this->query_items_;
+    std::size_t removed{0};
+    std::size_t kept{0};
+    std::size_t write = query_.first;
+    for (auto const & p : query_items) {
+        if ((p.second > 0) && predicate(std::string_view{url_}.substr(p.first, p.second))) {
+            ++removed;
+            continue;
+        }
+        if (kept > 0) {
+            url_[write++] = '&';
+        }
+        std::copy(url_.begin() + p.first, url_.begin() + p.first + p.second, url_.begin() + write);
+        query_items[kept++] = std::make_pair(write, p.second);
+        write += p.second;
+    }
+    if (removed == 0) {
+        return 0;        // nothing moved
+    }
+
+    // like parsing: no trailing empty item
+    while ((kept > 0) && (query_items[kept - 1].second == 0)) {
+        --kept;
+        write = kept > 0 ? write - 1 : query_.first;
+    }
+    query_items.resize(kept);
+
+    auto query_end = query_.first + query_.second;
+    if (kept == 0) {
+        write = query_.first - 1;        // drop the '?' too
+        query_present_ = false;
+    } else {
+        query_.second = write - query_.first;
+    }
+    url_.erase(write, query_end - write);
+    ShiftComponents(impl::URLComponent::kFragment,
+                    static_cast<std::ptrdiff_t>(write) - static_cast<std::ptrdiff_t>(query_end));
+
+    return removed;
+}
+
+
+template <typename Policy>
+inline std::ptrdiff_t headcode::url::BasicURL<Policy>::Replace(std::size_t pos,
+                                                               std::size_t length,
+                                                               std::string_view value) {
+    url_.replace(pos, length, value.data(), value.size());
+    return static_cast<std::ptrdiff_t>(value.size()) - static_cast<std::ptrdiff_t>(length);
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetFragment(std::string_view fragment) {
+
+    static_assert(Policy::kStoreFragment, "The fragment is not stored with this policy.");
+    if (!IsValid() || !impl::IsValidFragment(fragment)) {
+        return false;
+    }
+
+    if (this->fragment_present_) {
+        Replace(this->fragment_.first, this->fragment_.second, fragment);
+    } else {
+        url_.append(1, '#').append(fragment);
+        this->fragment_present_ = true;
+    }
+    this->fragment_ = std::make_pair(url_.size() - fragment.size(), fragment.size());
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetHost(std::string_view host) {
+
+    HostAddress host_address;
+    if (!IsValid() || !impl::ParseHost(host, host_address)) {
+        return false;
+    }
+
+    std::size_t begin;
+    std::ptrdiff_t delta;
+    if (HasAuthority()) {
+
+        bool port_present = HostEnd() < (authority_.first + authority_.second);
+        begin = HostBegin();
+        delta = Replace(begin, HostEnd() - begin, host);
+        authority_.second += static_cast<std::size_t>(delta);
+        if (port_present) {
+            port_.first += static_cast<std::size_t>(delta);
+        } else {
+            port_ = std::make_pair(begin + host.size(), 0);
+        }
+
+    } else {
+
+        // an authority demands an absolute or empty path
+        if ((path_.second > 0) && !IsPathAbsolute()) {
+            return false;
+        }
+        begin = authority_.first + 2;
+        delta = Replace(authority_.first, 0, std::string{"//"}.append(host));
+        authority_ = std::make_pair(begin, host.size());
+        userinfo_ = std::make_pair(begin, 0);
+        port_ = std::make_pair(begin + host.size(), 0);
+    }
+
+    host_ = std::make_pair(begin, host.size());
+    host_address_ = host_address;
+    if ((host_address_.type_ == HostType::kIPv6) || (host_address_.type_ == HostType::kIPvFuture)) {
+        host_.first++;
+        host_.second -= 2;
+    }
+    ShiftComponents(impl::URLComponent::kPath, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetPath(std::string_view path) {
+
+    if (!IsValid()) {
+        return false;
+    }
+
+    // without an authority a path must not start with "//" (this would become the authority)
+    bool has_authority = HasAuthority();
+    if (!has_authority && (path.substr(0, 2) == "//")) {
+        return false;
+    }
+
+    std::conditional_t<Policy::kSplitSegments, impl::Offsets, impl::OffsetCounter> segments;
+    std::pair<std::size_t, std::size_t> path_offsets;
+    auto [error, end] = impl::ParsePath(path, 0, has_authority, path_offsets, segments);
+    if ((error != ParseError::kNoError) || (end != path.size())) {
+        return false;
+    }
+
+    auto begin = path_.first;
+    auto delta = Replace(begin, path_.second, path);
+    path_.second = path.size();
+    if constexpr (Policy::kSplitSegments) {
+        for (auto & segment : segments) {
+            segment.first += begin;
+        }
+        this->segments_ = std::move(segments);
+    }
+    ShiftComponents(impl::URLComponent::kQuery, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetPort(std::uint16_t port_number) {
+
+    if (!IsValid() || !HasAuthority()) {
+        return false;
+    }
+
+    auto port = std::to_string(port_number);
+    auto begin = HostEnd();
+    auto delta = Replace(begin, authority_.first + authority_.second - begin, std::string{":"}.append(port));
+    authority_.second += static_cast<std::size_t>(delta);
+    port_ = std::make_pair(begin + 1, port.size());
+    port_number_ = port_number;
+    ShiftComponents(impl::URLComponent::kPath, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetQuery(std::string_view query) {
+
+    if (!IsValid()) {
+        return false;
+    }
+
+    std::conditional_t<Policy::kSplitQuery, impl::Offsets, impl::OffsetCounter> query_items;
+    std::pair<std::size_t, std::size_t> query_offsets;
+    auto [error, end] = impl::ParseQuery(query, 0, query_offsets, query_items);
+    if ((error != ParseError::kNoError) || (end != query.size())) {
+        return false;
+    }
+    if (query.empty()) {
+        query_items.clear();
+    }
+
+    std::size_t begin;
+    std::ptrdiff_t delta;
+    if (query_present_) {
+        begin = query_.first;
+        delta = Replace(begin, query_.second, query);
+    } else {
+        begin = path_.first + path_.second + 1;
+        delta = Replace(begin - 1, 0, std::string{"?"}.append(query));
+        query_present_ = true;
+    }
+    if constexpr (Policy::kSplitQuery) {
+        for (auto & query_item : query_items) {
+            query_item.first += begin;
+        }
+        this->query_items_ = std::move(query_items);
     }
-    ss << NormalizeQuery(GetQuery());
+    query_ = std::make_pair(begin, query.size());
+    ShiftComponents(impl::URLComponent::kFragment, delta);
+
+    return true;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURL<Policy>::SetScheme(std::string_view scheme) {
 
-    if (IsFragmentPresent()) {
-        ss << '#';
+    if (!IsValid() || scheme.empty() || !impl::IsAlpha(scheme[0]) ||
+        !std::all_of(scheme.begin(), scheme.end(), [](char c) { return impl::IsSchemeChar(c); })) {
+        return false;
     }
-    ss << NormalizeFragment(GetFragment());
 
-    return URL{ss.str()};
+    auto delta = Replace(0, scheme_.second, scheme);
+    scheme_ = std::make_pair(0, scheme.size());
+    scheme_kind_ = impl::ClassifyScheme(scheme);
+    ShiftComponents(impl::URLComponent::kAuthority, delta);
+
+    return true;
 }
 
 
-inline void headcode::url::URL::Parse() {
+template <typename Policy>
+inline void headcode::url::BasicURL<Policy>::ShiftComponents(impl::URLComponent from, std::ptrdiff_t delta) {
+
+    using impl::URLComponent;
+
+    auto shift = [delta](std::pair<std::size_t, std::size_t> & offsets) {
+        offsets.first = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offsets.first) + delta);
+    };
+
+    if (from <= URLComponent::kAuthority) {
+        shift(authority_);
+        shift(userinfo_);
+        shift(host_);
+        shift(port_);
+    }
+    if (from <= URLComponent::kPath) {
+        shift(path_);
+        if constexpr (Policy::kSplitSegments) {
+            std::for_each(this->segments_.begin(), this->segments_.end(), shift);
+        }
+    }
+    if (query_present_ && (from <= URLComponent::kQuery)) {
+        shift(query_);
+        if constexpr (Policy::kSplitQuery) {
+            std::for_each(this->query_items_.begin(), this->query_items_.end(), shift);
+        }
+    }
+    if (!query_present_) {
+        query_ = std::make_pair(path_.first + path_.second, 0);
+    }
+    if constexpr (Policy::kStoreFragment) {
+        if (this->fragment_present_) {
+            if (from <= URLComponent::kFragment) {
+                shift(this->fragment_);
+            }
+        } else {
+            this->fragment_ = std::make_pair(url_.size(), 0);
+        }
+    }
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURL<Policy>::Reset() {
+    error_ = ParseError::kURLEmpty;
+    authority_ = {0, 0};
+    host_ = {0, 0};
+    host_address_ = HostAddress{};
+    path_ = {0, 0};
+    port_ = {0, 0};
+    port_number_ = 0;
+    scheme_ = {0, 0};
+    scheme_kind_ = SchemeKind::kUnknown;
+    userinfo_ = {0, 0};
+    query_ = {0, 0};
+    query_present_ = false;
+    if constexpr (Policy::kSplitSegments) {
+        this->segments_.clear();
+    }
+    if constexpr (Policy::kSplitQuery) {
+        this->query_items_.clear();
+    }
+    if constexpr (Policy::kStoreFragment) {
+        this->fragment_ = {0, 0};
+        this->fragment_present_ = false;
+    }
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURL<Policy>::Assign(std::string_view url, TrustedInput) {
+    url_.assign(url.data(), url.size());
+    Reset();
+    Parse<false>();
+}
+
+
+template <typename Policy>
+template <bool Validate>
+inline void headcode::url::BasicURL<Policy>::Parse(ParseLimits const & limits) {
 
     // Strategy: work on the url_ field and parse in stages:
     // scheme -> hier-part -> authority -> path -> query -> fragment.
+    // Stages disabled by the policy work on local dummies and compile away.
+    // Without Validate the stages only locate the delimiters of the components.
 
     using namespace headcode::url::impl;
 
     if (url_.empty()) {
         error_ = ParseError::kURLEmpty;
+        CountParse(error_);
+        return;
+    }
+    if (url_.size() > limits.max_length_) {
+        error_ = ParseError::kURLTooLong;
+        CountParse(error_);
         return;
     }
 
+    OffsetCounter segment_counter;
+    OffsetCounter query_item_counter;
+    auto & segments = [&]() -> auto & {
+        if constexpr (Policy::kSplitSegments) {
+            return this->segments_;
+        } else {
+            return segment_counter;
+        }
+    }();
+    auto & query_items = [&]() -> auto & {
+        if constexpr (Policy::kSplitQuery) {
+            return this->query_items_;
+        } else {
+            return query_item_counter;
+        }
+    }();
+
     std::size_t pos{0};
     error_ = ParseError::kNoError;
     ParserState state = ParserState::kParsingScheme;
@@ -929,28 +2027,34 @@ inline void headcode::url::URL::Parse() {
 
         switch (state) {
 
-            case ParserState::kParsingScheme:
+            case ParserState::kParsingScheme: {
 
-                std::tie(error_, pos) = ParseScheme(url_sv, i, scheme_);
+                [[maybe_unused]] StageTimer timer{ParseStage::kScheme};
+                std::tie(error_, pos) = ParseScheme(url_sv, i, scheme_, scheme_kind_);
                 if (error_ == ParseError::kNoError) {
                     i = pos;
                     state = ParserState::kParsingHierPart;
                 }
                 break;
+            }
 
             case ParserState::kParsingHierPart:
 
                 authority_ = std::make_pair(i, 0);
                 host_ = std::make_pair(i, 0);
+                host_address_ = HostAddress{};
                 path_ = std::make_pair(i, 0);
-                segments_.clear();
+                segments.clear();
                 port_ = std::make_pair(i, 0);
+                port_number_ = 0;
                 userinfo_ = std::make_pair(i, 0);
                 query_ = std::make_pair(i, 0);
-                query_items_.clear();
-                fragment_ = std::make_pair(i, 0);
+                query_items.clear();
+                if constexpr (Policy::kStoreFragment) {
+                    this->fragment_ = std::make_pair(i, 0);
+                }
 
-                if ((i <= (url_.size() - 2)) && (url_.substr(i, 2) == "//")) {
+                if ((i <= (url_.size() - 2)) && (url_sv.substr(i, 2) == "//")) {
                     state = ParserState::kParsingAuthority;
                     ++i;
                 } else {
@@ -959,52 +2063,105 @@ inline void headcode::url::URL::Parse() {
                 }
                 break;
 
-            case ParserState::kParsingAuthority:
-                std::tie(error_, pos) = ParseAuthority(url_sv, i, authority_, userinfo_, host_, port_);
+            case ParserState::kParsingAuthority: {
+                [[maybe_unused]] StageTimer timer{ParseStage::kAuthority};
+                std::tie(error_, pos) = ParseAuthority<Validate>(url_sv,
+                                                       i,
+                                                       authority_,
+                                                       userinfo_,
+                                                       host_,
+                                                       host_address_,
+                                                       port_,
+                                                       port_number_,
+                                                       Policy::kValidateUserInfo);
                 if (error_ == ParseError::kNoError) {
                     i = pos - 1;
                     state = ParserState::kParsingPath;
                 }
                 break;
+            }
 
-            case ParserState::kParsingPath:
-                std::tie(error_, pos) = ParsePath(url_sv, i, authority_.second != 0, path_, segments_);
+            case ParserState::kParsingPath: {
+                [[maybe_unused]] StageTimer timer{ParseStage::kPath};
+                std::tie(error_, pos) =
+                        ParsePath<Validate>(url_sv, i, authority_.second != 0, path_, segments, limits.max_segments_);
                 if (error_ == ParseError::kNoError) {
                     i = pos - 1;
                     state = ParserState::kParsingQueryOrFragment;
                 }
                 break;
+            }
 
             case ParserState::kParsingQueryOrFragment:
+                // anchor the component right after its delimiter: it stays so if empty at the end
                 if (url_[i] == '?') {
                     query_present_ = true;
+                    query_ = std::make_pair(i + 1, 0);
                     state = ParserState::kParsingQuery;
                 } else if (url_[i] == '#') {
-                    fragment_present_ = true;
-                    state = ParserState::kParsingFragment;
+                    if constexpr (Policy::kStoreFragment) {
+                        this->fragment_present_ = true;
+                        this->fragment_ = std::make_pair(i + 1, 0);
+                        state = ParserState::kParsingFragment;
+                    } else {
+                        i = url_.size();        // the fragment is ignored
+                    }
                 }
                 break;
 
-            case ParserState::kParsingQuery:
-                std::tie(error_, pos) = ParseQuery(url_sv, i, query_, query_items_);
+            case ParserState::kParsingQuery: {
+                [[maybe_unused]] StageTimer timer{ParseStage::kQuery};
+                std::tie(error_, pos) = ParseQuery<Validate>(url_sv, i, query_, query_items, limits.max_query_items_);
                 if (error_ == ParseError::kNoError) {
                     i = pos;
-                    if ((i < url_.size()) && (url_[i] == '#')) {
-                        fragment_present_ = true;
+                    if constexpr (Policy::kStoreFragment) {
+                        if ((i < url_.size()) && (url_[i] == '#')) {
+                            this->fragment_present_ = true;
+                            this->fragment_ = std::make_pair(i + 1, 0);
+                        }
+                        state = ParserState::kParsingFragment;
+                    } else {
+                        i = url_.size();        // the fragment is ignored
                     }
-                    state = ParserState::kParsingFragment;
                 }
                 break;
+            }
 
-            case ParserState::kParsingFragment:
-                std::tie(error_, pos) = ParseFragment(url_sv, i, fragment_);
-                if (error_ == ParseError::kNoError) {
-                    i = pos;
-                    state = ParserState::kParsingFragment;
+            case ParserState::kParsingFragment: {
+                if constexpr (Policy::kStoreFragment) {
+                    [[maybe_unused]] StageTimer timer{ParseStage::kFragment};
+                    std::tie(error_, pos) = ParseFragment<Validate>(url_sv, i, this->fragment_);
+                    if (error_ == ParseError::kNoError) {
+                        i = pos;
+                        state = ParserState::kParsingFragment;
+                    }
                 }
                 break;
+            }
         }
     }
+
+    if (error_ == ParseError::kNoError) {
+        // the components of the stages not reached are empty at the end of the url
+        if (state <= ParserState::kParsingAuthority) {
+            AnchorEmptyComponents(URLComponent::kAuthority);
+            if (state == ParserState::kParsingAuthority) {
+                host_address_ = HostAddress{HostType::kRegName};        // "//" at the end: an empty host
+            }
+        } else if (state == ParserState::kParsingPath) {
+            AnchorEmptyComponents(URLComponent::kPath);
+        } else {
+            AnchorEmptyComponents(URLComponent::kQuery);
+        }
+    }
+    CountParse(error_);
+
+#ifdef DEBUG
+    if constexpr (!Validate) {
+        // debug builds double check the trusted input with the full validation
+        assert(BasicURL{url_}.IsValid() && "Trusted URL is not valid.");
+    }
+#endif
 }
 
 
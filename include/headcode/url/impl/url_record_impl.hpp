@@ -0,0 +1,367 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_RECORD_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_RECORD_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_RECORD_HPP
+#error "Do not include this file directly."
+#endif
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Magic bytes leading a file of URL records.
+ */
+constexpr char kURLRecordMagic[] = {'H', 'C', 'S', 'U', 'R', 'L'};
+
+
+/**
+ * @brief   Version of the URL record format.
+ */
+constexpr std::uint16_t kURLRecordVersion = 1;
+
+
+/**
+ * @brief   Size of the file header.
+ */
+constexpr std::size_t kURLRecordFileHeaderSize = sizeof(kURLRecordMagic) + 2;
+
+
+/**
+ * @brief   Offsets of the fields inside a record.
+ */
+enum URLRecordOffset : std::size_t {
+    kRecordSize = 0,                  //!< @brief Total size of the record.
+    kRecordURLSize = 4,               //!< @brief Size of the URL string.
+    kRecordError = 8,                 //!< @brief ParseError.
+    kRecordFlags = 9,                 //!< @brief Flags.
+    kRecordSchemeKind = 10,           //!< @brief SchemeKind.
+    kRecordHostType = 11,             //!< @brief HostType.
+    kRecordPortNumber = 12,           //!< @brief Port number.
+    kRecordIPv4 = 16,                 //!< @brief IPv4 address.
+    kRecordIPv6 = 20,                 //!< @brief IPv6 address.
+    kRecordAuthority = 36,            //!< @brief Start and length of the authority.
+    kRecordFragment = 44,             //!< @brief Start and length of the fragment.
+    kRecordHost = 52,                 //!< @brief Start and length of the host.
+    kRecordPath = 60,                 //!< @brief Start and length of the path.
+    kRecordPort = 68,                 //!< @brief Start and length of the port.
+    kRecordQuery = 76,                //!< @brief Start and length of the query.
+    kRecordScheme = 84,               //!< @brief Start and length of the scheme.
+    kRecordUserInfo = 92,             //!< @brief Start and length of the userinfo.
+    kRecordSegmentCount = 100,        //!< @brief Number of path segments.
+    kRecordQueryItemCount = 104,      //!< @brief Number of query items.
+    kRecordPairs = 108                //!< @brief Start of the segment and query item pairs.
+};
+
+
+/**
+ * @brief   Record flags.
+ */
+enum URLRecordFlags : std::uint8_t {
+    kRecordQueryPresent = 0x01,           //!< @brief Query is present.
+    kRecordFragmentPresent = 0x02         //!< @brief Fragment is present.
+};
+
+
+/**
+ * @brief   Overwrites a little endian 32 bit value inside a string.
+ * @param   data        the data to write to.
+ * @param   offset      the offset of the value in data.
+ * @param   value       the value to write.
+ */
+inline void WriteLittleEndian32(std::string & data, std::size_t offset, std::uint32_t value) {
+    for (std::size_t i = 0; i < 4; ++i) {
+        data[offset + i] = static_cast<char>((value >> (i * 8)) & 0xff);
+    }
+}
+
+
+/**
+ * @brief   Appends start and length of a sub string of url to the data.
+ * @param   data        the data to append to.
+ * @param   url         the full url.
+ * @param   part        a sub string inside the url.
+ */
+inline void AppendURLRecordPair(std::string & data, std::string_view const & url, std::string_view const & part) {
+    auto start = part.empty() ? 0 : static_cast<std::uint32_t>(part.data() - url.data());
+    AppendLittleEndian(data, start);
+    AppendLittleEndian(data, static_cast<std::uint32_t>(part.size()));
+}
+
+
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetAuthority() const {
+    return GetSlice(impl::kRecordAuthority);
+}
+
+
+inline headcode::url::ParseError headcode::url::URLRecord::GetError() const {
+    return static_cast<ParseError>(impl::ReadLittleEndian<std::uint8_t>(data_ + impl::kRecordError));
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetFragment() const {
+    return GetSlice(impl::kRecordFragment);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetHost() const {
+    return GetSlice(impl::kRecordHost);
+}
+
+
+inline headcode::url::HostType headcode::url::URLRecord::GetHostType() const {
+    return static_cast<HostType>(impl::ReadLittleEndian<std::uint8_t>(data_ + impl::kRecordHostType));
+}
+
+
+inline std::uint32_t headcode::url::URLRecord::GetIPv4() const {
+    return impl::ReadLittleEndian<std::uint32_t>(data_ + impl::kRecordIPv4);
+}
+
+
+inline std::array<std::uint8_t, 16> headcode::url::URLRecord::GetIPv6() const {
+    std::array<std::uint8_t, 16> ipv6;
+    for (std::size_t i = 0; i < ipv6.size(); ++i) {
+        ipv6[i] = static_cast<std::uint8_t>(data_[impl::kRecordIPv6 + i]);
+    }
+    return ipv6;
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetPath() const {
+    return GetSlice(impl::kRecordPath);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetPort() const {
+    return GetSlice(impl::kRecordPort);
+}
+
+
+inline std::uint16_t headcode::url::URLRecord::GetPortNumber() const {
+    return impl::ReadLittleEndian<std::uint16_t>(data_ + impl::kRecordPortNumber);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetQuery() const {
+    return GetSlice(impl::kRecordQuery);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetQueryItem(std::size_t n) const {
+    if (n >= GetQueryItemCount()) {
+        return std::string_view{};
+    }
+    return GetSlice(impl::kRecordPairs + (GetSegmentCount() + n) * 8);
+}
+
+
+inline std::size_t headcode::url::URLRecord::GetQueryItemCount() const {
+    return impl::ReadLittleEndian<std::uint32_t>(data_ + impl::kRecordQueryItemCount);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetScheme() const {
+    return GetSlice(impl::kRecordScheme);
+}
+
+
+inline headcode::url::SchemeKind headcode::url::URLRecord::GetSchemeKind() const {
+    return static_cast<SchemeKind>(impl::ReadLittleEndian<std::uint8_t>(data_ + impl::kRecordSchemeKind));
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetSegment(std::size_t n) const {
+    if (n >= GetSegmentCount()) {
+        return std::string_view{};
+    }
+    return GetSlice(impl::kRecordPairs + n * 8);
+}
+
+
+inline std::size_t headcode::url::URLRecord::GetSegmentCount() const {
+    return impl::ReadLittleEndian<std::uint32_t>(data_ + impl::kRecordSegmentCount);
+}
+
+
+inline std::size_t headcode::url::URLRecord::GetSize() const {
+    return impl::ReadLittleEndian<std::uint32_t>(data_ + impl::kRecordSize);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetSlice(std::size_t offset) const {
+
+    auto url = GetURL();
+    std::size_t start = impl::ReadLittleEndian<std::uint32_t>(data_ + offset);
+    std::size_t length = impl::ReadLittleEndian<std::uint32_t>(data_ + offset + 4);
+    if ((start > url.size()) || (length > url.size() - start)) {
+        return std::string_view{};
+    }
+
+    return url.substr(start, length);
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetURL() const {
+    auto pairs = (GetSegmentCount() + GetQueryItemCount()) * 8;
+    return std::string_view{data_ + impl::kRecordPairs + pairs,
+                            impl::ReadLittleEndian<std::uint32_t>(data_ + impl::kRecordURLSize)};
+}
+
+
+inline std::string_view headcode::url::URLRecord::GetUserInfo() const {
+    return GetSlice(impl::kRecordUserInfo);
+}
+
+
+inline bool headcode::url::URLRecord::IsFragmentPresent() const {
+    return impl::ReadLittleEndian<std::uint8_t>(data_ + impl::kRecordFlags) & impl::kRecordFragmentPresent;
+}
+
+
+inline bool headcode::url::URLRecord::IsQueryPresent() const {
+    return impl::ReadLittleEndian<std::uint8_t>(data_ + impl::kRecordFlags) & impl::kRecordQueryPresent;
+}
+
+
+inline headcode::url::URLRecordReader::Iterator::Iterator(std::string_view data, std::size_t pos)
+        : data_{data}, pos_{pos} {
+    Check();
+}
+
+
+inline void headcode::url::URLRecordReader::Iterator::Check() {
+
+    // A record is accepted if its fixed part, its pairs and its url are inside
+    // the record and the record itself lies inside the data. Bogus pairs are
+    // caught later by URLRecord::GetSlice().
+
+    if (pos_ >= data_.size()) {
+        pos_ = data_.size();
+        return;
+    }
+
+    auto available = data_.size() - pos_;
+    if (available < impl::kRecordPairs) {
+        pos_ = data_.size();
+        return;
+    }
+
+    URLRecord record{data_.data() + pos_};
+    auto size = record.GetSize();
+    std::uint64_t needed = impl::kRecordPairs +
+                           (std::uint64_t{record.GetSegmentCount()} + record.GetQueryItemCount()) * 8 +
+                           impl::ReadLittleEndian<std::uint32_t>(data_.data() + pos_ + impl::kRecordURLSize);
+    if ((size > available) || (needed > size) || (size % 4 != 0)) {
+        pos_ = data_.size();
+    }
+}
+
+
+inline headcode::url::URLRecordReader::Iterator & headcode::url::URLRecordReader::Iterator::operator++() {
+    pos_ += URLRecord{data_.data() + pos_}.GetSize();
+    Check();
+    return *this;
+}
+
+
+inline headcode::url::URLRecordReader::URLRecordReader(std::string_view data) {
+
+    using namespace headcode::url::impl;
+
+    if ((data.size() >= kURLRecordFileHeaderSize) &&
+        (data.substr(0, sizeof(kURLRecordMagic)) == std::string_view{kURLRecordMagic, sizeof(kURLRecordMagic)}) &&
+        (ReadLittleEndian<std::uint16_t>(data.data() + sizeof(kURLRecordMagic)) == kURLRecordVersion)) {
+        data_ = data;
+    }
+}
+
+
+inline headcode::url::URLRecordReader::Iterator headcode::url::URLRecordReader::begin() const {
+    if (data_.empty()) {
+        return end();
+    }
+    return Iterator{data_, impl::kURLRecordFileHeaderSize};
+}
+
+
+inline headcode::url::URLRecordReader::Iterator headcode::url::URLRecordReader::end() const {
+    return Iterator{data_, data_.size()};
+}
+
+
+inline headcode::url::URLRecordWriter::URLRecordWriter(std::ostream & out) : out_{out} {
+    out_.write(impl::kURLRecordMagic, sizeof(impl::kURLRecordMagic));
+    std::string version;
+    impl::AppendLittleEndian(version, impl::kURLRecordVersion);
+    out_.write(version.data(), version.size());
+}
+
+
+inline void headcode::url::URLRecordWriter::Write(URL const & url) {
+
+    using namespace headcode::url::impl;
+
+    std::string_view url_sv{url.GetURL()};
+    auto segments = url.Segments();
+    auto query_items = url.QueryItems();
+
+    buffer_.clear();
+    AppendLittleEndian(buffer_, std::uint32_t{0});        // record size: patched below
+    AppendLittleEndian(buffer_, static_cast<std::uint32_t>(url_sv.size()));
+    AppendLittleEndian(buffer_, static_cast<std::uint8_t>(url.GetError()));
+    std::uint8_t flags = (url.IsQueryPresent() ? kRecordQueryPresent : 0) |
+                         (url.IsFragmentPresent() ? kRecordFragmentPresent : 0);
+    AppendLittleEndian(buffer_, flags);
+    AppendLittleEndian(buffer_, static_cast<std::uint8_t>(url.GetSchemeKind()));
+    AppendLittleEndian(buffer_, static_cast<std::uint8_t>(url.GetHostType()));
+    AppendLittleEndian(buffer_, url.GetPortNumber());
+    AppendLittleEndian(buffer_, std::uint16_t{0});
+    AppendLittleEndian(buffer_, url.GetIPv4());
+    for (auto b : url.GetIPv6()) {
+        AppendLittleEndian(buffer_, b);
+    }
+
+    AppendURLRecordPair(buffer_, url_sv, url.GetAuthority());
+    AppendURLRecordPair(buffer_, url_sv, url.GetFragment());
+    AppendURLRecordPair(buffer_, url_sv, url.GetHost());
+    AppendURLRecordPair(buffer_, url_sv, url.GetPath());
+    AppendURLRecordPair(buffer_, url_sv, url.GetPort());
+    AppendURLRecordPair(buffer_, url_sv, url.GetQuery());
+    AppendURLRecordPair(buffer_, url_sv, url.GetScheme());
+    AppendURLRecordPair(buffer_, url_sv, url.GetUserInfo());
+
+    AppendLittleEndian(buffer_, static_cast<std::uint32_t>(segments.size()));
+    AppendLittleEndian(buffer_, static_cast<std::uint32_t>(query_items.size()));
+    for (auto const & segment : segments) {
+        AppendURLRecordPair(buffer_, url_sv, segment);
+    }
+    for (auto const & query_item : query_items) {
+        AppendURLRecordPair(buffer_, url_sv, query_item);
+    }
+
+    buffer_.append(url_sv);
+    buffer_.append((4 - buffer_.size() % 4) % 4, '\0');
+    WriteLittleEndian32(buffer_, kRecordSize, static_cast<std::uint32_t>(buffer_.size()));
+
+    out_.write(buffer_.data(), buffer_.size());
+    ++count_;
+}
+
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_SCANNER_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_SCANNER_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_SCANNER_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(HEADCODE_SPACE_URL_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Creates the table of the characters valid in an URL (besides '%').
+ * @return  A table indexed by the unsigned character.
+ */
+constexpr std::array<bool, 256> MakeURLCharacterTable() {
+
+    // unreserved / gen-delims / sub-delims
+    constexpr char symbols[] = "-._~:/?#[]@!$&'()*+,;=";
+
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = true;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        table[c] = true;
+        table[c + 0x20] = true;
+    }
+    for (std::size_t i = 0; i + 1 < sizeof(symbols); ++i) {
+        table[static_cast<unsigned char>(symbols[i])] = true;
+    }
+    return table;
+}
+
+
+/**
+ * @brief   The characters valid in an URL (besides '%').
+ */
+constexpr std::array<bool, 256> kURLCharacters = MakeURLCharacterTable();
+
+
+/**
+ * @brief   Checks if a character is trailing punctuation of the text rather than part of an URL.
+ * @param   c       the last character of an URL candidate.
+ * @return  true, if c is cut off.
+ */
+inline bool IsTrailingPunctuation(char c) {
+    return (c == '.') || (c == ',') || (c == ';') || (c == ':') || (c == '!') || (c == '?') || (c == '\'');
+}
+
+
+#ifdef HEADCODE_SPACE_URL_SSE2
+
+/**
+ * @brief   Finds the characters of a block which are not valid in an URL (or '%').
+ * @param   v       16 characters.
+ * @return  A bit mask with bit i set if character i is not printable ASCII or one of "\"%<>\\^`{|}".
+ */
+inline int GetNonURLMask(__m128i v) {
+
+    // bytes >= 0x80 are negative: the signed compare catches them too
+    auto bad = _mm_or_si128(_mm_cmplt_epi8(v, _mm_set1_epi8(0x21)), _mm_cmpgt_epi8(v, _mm_set1_epi8(0x7e)));
+    auto is = [v](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+    bad = _mm_or_si128(bad, _mm_or_si128(_mm_or_si128(is('"'), is('%')), _mm_or_si128(is('<'), is('>'))));
+    bad = _mm_or_si128(bad, _mm_or_si128(_mm_or_si128(is('\\'), is('^')), _mm_or_si128(is('`'), is('|'))));
+    bad = _mm_or_si128(bad, _mm_or_si128(is('{'), is('}')));
+    return _mm_movemask_epi8(bad);
+}
+
+
+/**
+ * @brief   Returns the index of the lowest bit set.
+ * @param   mask        a non-zero mask.
+ * @return  The number of trailing zero bits.
+ */
+inline std::size_t CountTrailingZeros(int mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, static_cast<unsigned long>(mask));
+    return index;
+#else
+    return static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+#endif
+}
+
+#endif
+
+
+/**
+ * @brief   Returns the end of the maximal run of URL characters.
+ *
+ * With SSE2 16 characters are checked per step: the scan jumps right to
+ * the first character which is not plainly valid (the end or a '%').
+ *
+ * @param   text        the text.
+ * @param   start       the start of the run.
+ * @param   quoted      the URL is quoted: the run ends at the first '\''.
+ * @return  The index right after the run.
+ */
+inline std::size_t ExtendURL(std::string_view const & text, std::size_t start, bool quoted) {
+
+    auto i = start;
+    while (i < text.size()) {
+#ifdef HEADCODE_SPACE_URL_SSE2
+        if (i + 16 <= text.size()) {
+            auto v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(text.data() + i));
+            auto mask = GetNonURLMask(v);
+            if (quoted) {
+                mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+            }
+            if (mask == 0) {
+                i += 16;
+                continue;
+            }
+            i += CountTrailingZeros(mask);
+        }
+#endif
+        auto c = text[i];
+        if (quoted && (c == '\'')) {
+            break;
+        }
+        if (kURLCharacters[static_cast<unsigned char>(c)]) {
+            ++i;
+        } else if ((c == '%') && (i + 2 < text.size()) && IsHexDigit(text[i + 1]) && IsHexDigit(text[i + 2])) {
+            i += 3;
+        } else {
+            break;
+        }
+    }
+    return i;
+}
+
+
+/**
+ * @brief   Cuts off trailing punctuation and unbalanced closing brackets of an URL candidate.
+ * @param   text        the text.
+ * @param   start       the start of the candidate.
+ * @param   min_end     the candidate may not be shorter ("scheme://").
+ * @param   end         the end of the candidate.
+ * @return  The new end of the candidate.
+ */
+inline std::size_t TrimURL(std::string_view const & text, std::size_t start, std::size_t min_end, std::size_t end) {
+
+    // the brackets are counted once and only if there is a closing one at the end (rare)
+    std::ptrdiff_t parentheses{0};
+    std::ptrdiff_t brackets{0};
+    bool counted{false};
+    auto count = [&]() {
+        if (!counted) {
+            auto candidate = text.substr(start, end - start);
+            parentheses = std::count(candidate.begin(), candidate.end(), '(') -
+                          std::count(candidate.begin(), candidate.end(), ')');
+            brackets = std::count(candidate.begin(), candidate.end(), '[') -
+                       std::count(candidate.begin(), candidate.end(), ']');
+            counted = true;
+        }
+    };
+
+    while (end > min_end) {
+        auto c = text[end - 1];
+        if ((c == ')') || (c == ']')) {
+            count();
+        }
+        if (IsTrailingPunctuation(c)) {
+            --end;
+        } else if ((c == ')') && (parentheses < 0)) {
+            ++parentheses;
+            --end;
+        } else if ((c == ']') && (brackets < 0)) {
+            ++brackets;
+            --end;
+        } else {
+            break;
+        }
+    }
+    return end;
+}
+
+
+}
+
+
+inline bool headcode::url::URLScanner::Next(std::string_view & url) {
+
+    // Strategy: jump from ':' to ':' with memchr(). At a "://" walk back over
+    // the scheme characters (no further than the end of the last URL) and
+    // forward over the URL characters. Neither walk crosses a ':' of another
+    // candidate's scheme, so each character is visited a bounded number of times.
+
+    using namespace headcode::url::impl;
+
+    auto search = position_;
+    while (search < text_.size()) {
+
+        auto colon = static_cast<char const *>(std::memchr(text_.data() + search, ':', text_.size() - search));
+        if (colon == nullptr) {
+            break;
+        }
+        auto pos = static_cast<std::size_t>(colon - text_.data());
+        search = pos + 1;
+        if (text_.substr(pos, 3) != "://") {
+            continue;
+        }
+
+        auto start = pos;
+        while ((start > position_) && IsSchemeChar(text_[start - 1])) {
+            --start;
+        }
+        while ((start < pos) && !IsAlpha(text_[start])) {
+            ++start;
+        }
+        if (start == pos) {
+            continue;
+        }
+
+        // quoted (e.g. an HTML attribute): the quote ends the URL, the run never crosses it
+        bool quoted = (start > 0) && (text_[start - 1] == '\'');
+        auto end = ExtendURL(text_, pos + 3, quoted);
+        end = TrimURL(text_, start, pos + 3, end);
+        if (end == pos + 3) {
+            continue;
+        }
+
+        url = text_.substr(start, end - start);
+        position_ = end;
+        return true;
+    }
+
+    position_ = text_.size();
+    return false;
+}
+
+
+template <typename Policy>
+inline bool headcode::url::URLScanner::Next(BasicURL<Policy> & url) {
+
+    std::string_view candidate;
+    while (Next(candidate)) {
+        url.Assign(candidate);
+        if (url.IsValid()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+#endif
@@ -0,0 +1,529 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_STREAM_PARSER_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_STREAM_PARSER_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_STREAM_PARSER_HPP
+#error "Do not include this file directly."
+#endif
+
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   The number of scheme characters carried over: more than any well known scheme has.
+ */
+constexpr std::size_t kSchemeCarrySize{8};
+
+
+/**
+ * @brief   Classes of characters in path, query and fragment.
+ */
+enum StreamCharacterClass : std::uint8_t {
+    kPathCharacter = 0x01,         //!< @brief Valid in a path segment: unreserved, sub-delims, ':' and '@'.
+    kQueryCharacter = 0x02         //!< @brief Valid in a query or a fragment: the above, '/' and '?'.
+};
+
+
+/**
+ * @brief   Creates the table of the character classes of path, query and fragment (besides '%').
+ * @return  A table indexed by the unsigned character.
+ */
+constexpr std::array<std::uint8_t, 256> MakeStreamCharacterTable() {
+
+    // unreserved / sub-delims / ':' / '@'
+    constexpr char symbols[] = "-._~!$&'()*+,;=:@";
+
+    std::array<std::uint8_t, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = kPathCharacter | kQueryCharacter;
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) {
+        table[c] = kPathCharacter | kQueryCharacter;
+        table[c + 0x20] = kPathCharacter | kQueryCharacter;
+    }
+    for (std::size_t i = 0; i + 1 < sizeof(symbols); ++i) {
+        table[static_cast<unsigned char>(symbols[i])] = kPathCharacter | kQueryCharacter;
+    }
+    table['/'] = kQueryCharacter;
+    table['?'] = kQueryCharacter;
+    return table;
+}
+
+
+/**
+ * @brief   The character classes of path, query and fragment.
+ */
+constexpr std::array<std::uint8_t, 256> kStreamCharacters = MakeStreamCharacterTable();
+
+
+/**
+ * @brief   Checks if a character is valid in a path segment (besides '%').
+ * @param   c       the character to check.
+ * @return  true, if it is.
+ */
+inline bool IsPathChar(char c) {
+    return (kStreamCharacters[static_cast<unsigned char>(c)] & kPathCharacter) != 0;
+}
+
+
+/**
+ * @brief   Checks if a character is valid in a query or a fragment (besides '%').
+ * @param   c       the character to check.
+ * @return  true, if it is.
+ */
+inline bool IsQueryChar(char c) {
+    return (kStreamCharacters[static_cast<unsigned char>(c)] & kQueryCharacter) != 0;
+}
+
+
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURLStreamParser<Policy>::Feed(std::string_view chunk) {
+
+    // Strategy: the stages of BasicURL::Parse() as a state machine which is
+    // left at the end of a chunk and resumed with the next one. Each stage
+    // consumes as much of the chunk as it can and hands over at its delimiter.
+
+    using impl::ParserState;
+
+    offset_ = size_;
+    size_ += chunk.size();
+    if (size_ > limits_.max_length_) {
+        error_ = ParseError::kURLTooLong;
+    }
+
+    std::size_t i{0};
+    while ((i < chunk.size()) && (error_ == ParseError::kNoError)) {
+
+        switch (state_) {
+
+            case ParserState::kParsingScheme:
+                i = FeedScheme(chunk, i);
+                break;
+
+            case ParserState::kParsingHierPart:
+                i = FeedHierPart(chunk, i);
+                break;
+
+            case ParserState::kParsingAuthority:
+                i = FeedAuthority(chunk, i);
+                break;
+
+            case ParserState::kParsingPath:
+                i = FeedPath(chunk, i);
+                break;
+
+            case ParserState::kParsingQueryOrFragment:
+                if (chunk[i] == '?') {
+                    query_present_ = true;
+                    query_ = std::make_pair(offset_ + i + 1, 0);
+                    item_start_ = query_.first;
+                    state_ = ParserState::kParsingQuery;
+                } else {
+                    fragment_present_ = true;
+                    fragment_ = std::make_pair(offset_ + i + 1, 0);
+                    state_ = ParserState::kParsingFragment;
+                }
+                ++i;
+                break;
+
+            case ParserState::kParsingQuery:
+                i = FeedQuery(chunk, i);
+                break;
+
+            case ParserState::kParsingFragment:
+                i = FeedFragment(chunk, i);
+                break;
+        }
+    }
+
+    return IsValid();
+}
+
+
+template <typename Policy>
+inline bool headcode::url::BasicURLStreamParser<Policy>::Finish() {
+
+    using namespace headcode::url::impl;
+
+    if (size_ == 0) {
+        error_ = ParseError::kURLEmpty;
+    }
+
+    if (error_ == ParseError::kNoError) {
+
+        // like BasicURL::Parse() the components of the stages not reached are empty at the end
+        auto end = std::make_pair(size_, std::size_t{0});
+        switch (state_) {
+
+            case ParserState::kParsingScheme:
+                error_ = ParseError::kInvalidScheme;
+                break;
+
+            case ParserState::kParsingHierPart:
+                if (slash_pending_) {
+                    slash_pending_ = false;
+                    StartPath(size_ - 1);
+                    item_start_ = size_;
+                    EndPath(size_);
+                } else {
+                    authority_ = userinfo_ = host_ = port_ = path_ = end;
+                }
+                query_ = fragment_ = end;
+                break;
+
+            case ParserState::kParsingAuthority:
+                if (!carry_.empty()) {
+                    EndAuthority();
+                } else {
+                    host_address_ = HostAddress{HostType::kRegName};        // "//" at the end: an empty host
+                }
+                path_ = query_ = fragment_ = end;
+                break;
+
+            case ParserState::kParsingPath:
+                EndPath(size_);
+                query_ = fragment_ = end;
+                break;
+
+            case ParserState::kParsingQueryOrFragment:
+                break;
+
+            case ParserState::kParsingQuery:
+                EndQuery(size_);
+                fragment_ = end;
+                break;
+
+            case ParserState::kParsingFragment:
+                fragment_.second = size_ - fragment_.first;
+                if constexpr (Policy::kStoreFragment) {
+                    if (pending_hex_ > 0) {
+                        error_ = ParseError::kInvalidFragment;
+                    }
+                }
+                break;
+        }
+    }
+
+    CountParse(error_);
+    return IsValid();
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLStreamParser<Policy>::Reset(ParseLimits const & limits) {
+    auto carry = std::move(carry_);
+    carry.clear();
+    *this = BasicURLStreamParser{limits};
+    carry_ = std::move(carry);
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLStreamParser<Policy>::EndAuthority() {
+
+    // the carry-over holds the authority and its delimiter (if any), which ParseAuthority() stops at
+    [[maybe_unused]] impl::StageTimer timer{ParseStage::kAuthority};
+    auto start = authority_.first;
+    std::tie(error_, std::ignore) = impl::ParseAuthority(std::string_view{carry_},
+                                                         0,
+                                                         authority_,
+                                                         userinfo_,
+                                                         host_,
+                                                         host_address_,
+                                                         port_,
+                                                         port_number_,
+                                                         Policy::kValidateUserInfo);
+    authority_.first += start;
+    userinfo_.first += start;
+    host_.first += start;
+    port_.first += start;
+    carry_.clear();
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLStreamParser<Policy>::EndPath(std::size_t end) {
+
+    path_.second = end - path_.first;
+    if (path_.second == 0) {
+        return;
+    }
+    if (pending_hex_ > 0) {
+        error_ = ParseError::kInvalidPath;
+        return;
+    }
+
+    // the last segment counts unless empty after others (see impl::AddLastItem())
+    if ((end > item_start_) || (segment_count_ == 0)) {
+        if (segment_count_ == limits_.max_segments_) {
+            error_ = ParseError::kTooManySegments;
+            return;
+        }
+        ++segment_count_;
+    }
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLStreamParser<Policy>::EndQuery(std::size_t end) {
+
+    query_.second = end - query_.first;
+    if (pending_hex_ > 0) {
+        error_ = ParseError::kInvalidQuery;
+        return;
+    }
+    if (query_.second == 0) {
+        return;        // an empty query has no items (see impl::ParseQuery())
+    }
+
+    if ((end > item_start_) || (query_item_count_ == 0)) {
+        if (query_item_count_ == limits_.max_query_items_) {
+            error_ = ParseError::kTooManyQueryItems;
+            return;
+        }
+        ++query_item_count_;
+    }
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedAuthority(std::string_view chunk, std::size_t i) {
+
+    auto end = chunk.find_first_of("/?#", i);
+    if (end == std::string_view::npos) {
+        carry_.append(chunk.data() + i, chunk.size() - i);
+        return chunk.size();
+    }
+
+    carry_.append(chunk.data() + i, end - i + 1);
+    EndAuthority();
+    if (error_ == ParseError::kNoError) {
+        StartPath(offset_ + end);
+    }
+    return end;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedFragment(std::string_view chunk, std::size_t i) {
+
+    if constexpr (!Policy::kStoreFragment) {
+        return chunk.size();        // the fragment is ignored
+    }
+
+    [[maybe_unused]] impl::StageTimer timer{ParseStage::kFragment};
+    for (; i < chunk.size(); ++i) {
+
+        char c = chunk[i];
+        if (pending_hex_ > 0) {
+            if (!impl::IsHexDigit(c)) {
+                error_ = ParseError::kInvalidFragment;
+                return i;
+            }
+            --pending_hex_;
+            continue;
+        }
+        if (impl::IsQueryChar(c)) {
+            continue;
+        }
+        if (c == '%') {
+            pending_hex_ = 2;
+            continue;
+        }
+
+        error_ = ParseError::kInvalidFragment;
+        return i;
+    }
+
+    return i;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedHierPart(std::string_view chunk, std::size_t i) {
+
+    // "//" starts the authority, anything else the path: the two slashes may be split
+    if (!slash_pending_) {
+        if (chunk[i] != '/') {
+            StartPath(offset_ + i);
+            return i;
+        }
+        slash_pending_ = true;
+        if (++i == chunk.size()) {
+            return i;
+        }
+    }
+
+    slash_pending_ = false;
+    if (chunk[i] == '/') {
+        authority_ = std::make_pair(offset_ + i + 1, 0);
+        state_ = impl::ParserState::kParsingAuthority;
+        return i + 1;
+    }
+
+    // the pending '/' (maybe in the last chunk) starts an absolute path
+    StartPath(offset_ + i - 1);
+    item_start_ = offset_ + i;
+    return i;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedPath(std::string_view chunk, std::size_t i) {
+
+    [[maybe_unused]] impl::StageTimer timer{ParseStage::kPath};
+    for (; i < chunk.size(); ++i) {
+
+        char c = chunk[i];
+        if (pending_hex_ > 0) {
+            if (!impl::IsHexDigit(c)) {
+                error_ = ParseError::kInvalidPath;
+                return i;
+            }
+            --pending_hex_;
+            continue;
+        }
+        if ((c == '?') || (c == '#')) {
+            EndPath(offset_ + i);
+            state_ = impl::ParserState::kParsingQueryOrFragment;
+            return i;
+        }
+        if (c == '/') {
+            auto pos = offset_ + i;
+            if (pos != path_.first) {
+                if (segment_count_ == limits_.max_segments_) {
+                    error_ = ParseError::kTooManySegments;
+                    return i;
+                }
+                ++segment_count_;
+            }
+            item_start_ = pos + 1;
+            continue;
+        }
+        if (impl::IsPathChar(c)) {
+            continue;
+        }
+        if (c == '%') {
+            pending_hex_ = 2;
+            continue;
+        }
+
+        error_ = ParseError::kInvalidPath;
+        return i;
+    }
+
+    return i;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedQuery(std::string_view chunk, std::size_t i) {
+
+    [[maybe_unused]] impl::StageTimer timer{ParseStage::kQuery};
+    for (; i < chunk.size(); ++i) {
+
+        char c = chunk[i];
+        if (pending_hex_ > 0) {
+            if (!impl::IsHexDigit(c)) {
+                error_ = ParseError::kInvalidQuery;
+                return i;
+            }
+            --pending_hex_;
+            continue;
+        }
+        if (c == '#') {
+            EndQuery(offset_ + i);
+            state_ = impl::ParserState::kParsingQueryOrFragment;
+            return i;
+        }
+        if (c == '&') {
+            if (query_item_count_ == limits_.max_query_items_) {
+                error_ = ParseError::kTooManyQueryItems;
+                return i;
+            }
+            ++query_item_count_;
+            item_start_ = offset_ + i + 1;
+            continue;
+        }
+        if (impl::IsQueryChar(c)) {
+            continue;
+        }
+        if (c == '%') {
+            pending_hex_ = 2;
+            continue;
+        }
+
+        error_ = ParseError::kInvalidQuery;
+        return i;
+    }
+
+    return i;
+}
+
+
+template <typename Policy>
+inline std::size_t headcode::url::BasicURLStreamParser<Policy>::FeedScheme(std::string_view chunk, std::size_t i) {
+
+    using namespace headcode::url::impl;
+
+    [[maybe_unused]] StageTimer timer{ParseStage::kScheme};
+    auto start = i;
+    for (; (i < chunk.size()) && (chunk[i] != ':'); ++i) {
+        if (!((offset_ + i == 0) ? IsAlpha(chunk[i]) : IsSchemeChar(chunk[i]))) {
+            error_ = ParseError::kInvalidSchemeChar;
+            return i;
+        }
+    }
+
+    // only as many characters as needed to classify the scheme are carried over
+    carry_.append(chunk.data() + start, std::min(i - start, kSchemeCarrySize - carry_.size()));
+    if (i == chunk.size()) {
+        return i;
+    }
+
+    auto pos = offset_ + i;
+    if (pos == 0) {
+        error_ = ParseError::kInvalidSchemeChar;
+        return i;
+    }
+    scheme_ = std::make_pair(0, pos);
+    scheme_kind_ = (pos < kSchemeCarrySize) ? ClassifyScheme(carry_) : SchemeKind::kUnknown;
+    carry_.clear();
+
+    auto empty = std::make_pair(pos + 1, std::size_t{0});
+    authority_ = userinfo_ = host_ = port_ = path_ = query_ = fragment_ = empty;
+    state_ = ParserState::kParsingHierPart;
+    return i + 1;
+}
+
+
+template <typename Policy>
+inline void headcode::url::BasicURLStreamParser<Policy>::StartPath(std::size_t start) {
+    path_ = std::make_pair(start, 0);
+    item_start_ = start;
+    pending_hex_ = 0;
+    state_ = impl::ParserState::kParsingPath;
+}
+
+
+#endif
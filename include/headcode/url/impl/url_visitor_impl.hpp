@@ -0,0 +1,218 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_VISITOR_IMPL_HPP
+#define HEADCODE_SPACE_URL_URL_VISITOR_IMPL_HPP
+
+
+#ifndef HEADCODE_SPACE_URL_URL_VISITOR_HPP
+#error "Do not include this file directly."
+#endif
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace headcode::url::impl {
+
+
+/**
+ * @brief   Passes the items split by ParsePath or ParseQuery to a visitor instead of storing them.
+ *
+ * This is a drop-in for the Offsets of the parse functions: only the number
+ * of items is kept (for the limits and the rule of the last item).
+ */
+template <typename Callback>
+class VisitingOffsets {
+
+    std::string_view url_;        //!< @brief The scanned URL.
+    Callback callback_;           //!< @brief Called with each item.
+    std::size_t count_{0};        //!< @brief The number of items.
+    bool stopped_{false};         //!< @brief The callback asked to stop.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   url         the scanned URL.
+     * @param   callback    called with each item, returns false to stop.
+     */
+    VisitingOffsets(std::string_view url, Callback callback) : url_{url}, callback_{callback} {
+    }
+
+    /**
+     * @brief   Forgets all items (the items already passed stay passed).
+     */
+    void clear() {
+        count_ = 0;
+    }
+
+    /**
+     * @brief   Passes an item to the callback (unless stopped).
+     * @param   start       start of the item in the URL.
+     * @param   length      length of the item.
+     */
+    void emplace_back(std::size_t start, std::size_t length) {
+        ++count_;
+        if (!stopped_) {
+            stopped_ = !callback_(url_.substr(start, length));
+        }
+    }
+
+    /**
+     * @brief   Checks if there are no items.
+     * @return  true, if no item has been passed.
+     */
+    [[nodiscard]] bool empty() const {
+        return count_ == 0;
+    }
+
+    /**
+     * @brief   Returns the number of items.
+     * @return  The number of items passed.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count_;
+    }
+
+    /**
+     * @brief   Checks if the callback asked to stop.
+     * @return  true, if a callback returned false.
+     */
+    [[nodiscard]] bool IsStopped() const {
+        return stopped_;
+    }
+};
+
+
+/**
+ * @brief   Creates a VisitingOffsets object.
+ * @param   url         the scanned URL.
+ * @param   callback    called with each item, returns false to stop.
+ * @return  The VisitingOffsets object.
+ */
+template <typename Callback>
+inline VisitingOffsets<Callback> MakeVisitingOffsets(std::string_view url, Callback callback) {
+    return VisitingOffsets<Callback>{url, callback};
+}
+
+
+/**
+ * @brief   Scans an URL and passes the components to a visitor.
+ * @param   url         the URL to scan.
+ * @param   visitor     the visitor.
+ * @param   limits      the limits to apply while scanning.
+ * @return  The error found (ParseError::kNoError if valid or stopped by the visitor).
+ */
+template <typename Visitor>
+inline ParseError VisitURLStages(std::string_view url, Visitor & visitor, ParseLimits const & limits) {
+
+    // Strategy: the very same stages as BasicURL::Parse(), but each component
+    // is handed to the visitor right after its stage instead of being stored.
+
+    if (url.empty()) {
+        return ParseError::kURLEmpty;
+    }
+    if (url.size() > limits.max_length_) {
+        return ParseError::kURLTooLong;
+    }
+
+    ParseError error;
+    std::size_t pos;
+    std::pair<std::size_t, std::size_t> scheme;
+    SchemeKind scheme_kind;
+    {
+        [[maybe_unused]] StageTimer timer{ParseStage::kScheme};
+        std::tie(error, pos) = ParseScheme(url, 0, scheme, scheme_kind);
+    }
+    if (error != ParseError::kNoError) {
+        return error;
+    }
+    if (!visitor.OnScheme(url.substr(scheme.first, scheme.second), scheme_kind)) {
+        return ParseError::kNoError;
+    }
+    ++pos;
+
+    bool authority_present = url.substr(pos, 2) == "//";
+    if (authority_present) {
+
+        std::pair<std::size_t, std::size_t> authority;
+        std::pair<std::size_t, std::size_t> userinfo;
+        std::pair<std::size_t, std::size_t> host;
+        HostAddress host_address;
+        std::pair<std::size_t, std::size_t> port;
+        std::uint16_t port_number;
+        {
+            [[maybe_unused]] StageTimer timer{ParseStage::kAuthority};
+            std::tie(error, pos) =
+                    ParseAuthority(url, pos + 2, authority, userinfo, host, host_address, port, port_number);
+        }
+        if (error != ParseError::kNoError) {
+            return error;
+        }
+
+        bool userinfo_present = (userinfo.second > 0) || ((authority.second > 0) && (url[authority.first] == '@'));
+        if (userinfo_present && !visitor.OnUserInfo(url.substr(userinfo.first, userinfo.second))) {
+            return ParseError::kNoError;
+        }
+        if (!visitor.OnHost(url.substr(host.first, host.second), host_address)) {
+            return ParseError::kNoError;
+        }
+        if ((port.second > 0) && !visitor.OnPort(url.substr(port.first, port.second), port_number)) {
+            return ParseError::kNoError;
+        }
+    }
+
+    {
+        [[maybe_unused]] StageTimer timer{ParseStage::kPath};
+        auto segments = MakeVisitingOffsets(url, [&](std::string_view segment) { return visitor.OnSegment(segment); });
+        std::pair<std::size_t, std::size_t> path;
+        std::tie(error, pos) = ParsePath(url, pos, authority_present, path, segments, limits.max_segments_);
+        if ((error != ParseError::kNoError) || segments.IsStopped()) {
+            return error;
+        }
+    }
+
+    if ((pos < url.size()) && (url[pos] == '?')) {
+        [[maybe_unused]] StageTimer timer{ParseStage::kQuery};
+        auto query_items =
+                MakeVisitingOffsets(url, [&](std::string_view query_item) { return visitor.OnQueryItem(query_item); });
+        std::pair<std::size_t, std::size_t> query;
+        std::tie(error, pos) = ParseQuery(url, pos + 1, query, query_items, limits.max_query_items_);
+        if ((error != ParseError::kNoError) || query_items.IsStopped()) {
+            return error;
+        }
+    }
+
+    if ((pos < url.size()) && (url[pos] == '#')) {
+        [[maybe_unused]] StageTimer timer{ParseStage::kFragment};
+        std::pair<std::size_t, std::size_t> fragment;
+        std::tie(error, pos) = ParseFragment(url, pos + 1, fragment);
+        if (error != ParseError::kNoError) {
+            return error;
+        }
+        visitor.OnFragment(url.substr(fragment.first, fragment.second));
+    }
+
+    return ParseError::kNoError;
+}
+
+
+}
+
+
+template <typename Visitor>
+inline headcode::url::ParseError headcode::url::VisitURL(std::string_view url,
+                                                         Visitor & visitor,
+                                                         ParseLimits const & limits) {
+    auto error = impl::VisitURLStages(url, visitor, limits);
+    impl::CountParse(error);
+    return error;
+}
+
+
+#endif
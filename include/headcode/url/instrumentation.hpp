@@ -0,0 +1,124 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_INSTRUMENTATION_HPP
+#define HEADCODE_SPACE_URL_INSTRUMENTATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+/**
+ * Parse instrumentation is opt-in: define HEADCODE_SPACE_URL_INSTRUMENTATION
+ * for the whole program (e.g. -DHEADCODE_SPACE_URL_INSTRUMENTATION) to collect
+ * per-stage counters and timings, offset allocation counts and error counts. Without
+ * the define all hooks are empty and compile away.
+ */
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+enum class ParseError;
+
+
+/**
+ * @brief   The instrumented stages of parsing.
+ */
+enum class ParseStage {
+    kScheme = 0,          //!< @brief Parsing the scheme.
+    kAuthority,           //!< @brief Parsing the authority.
+    kPath,                //!< @brief Parsing the path.
+    kQuery,               //!< @brief Parsing the query.
+    kFragment,            //!< @brief Parsing the fragment.
+    kNormalize            //!< @brief Normalizing an URL.
+};
+
+
+/**
+ * @brief   The number of ParseStage values.
+ */
+constexpr std::size_t kParseStageCount = 6;
+
+
+/**
+ * @brief   The number of ParseError values.
+ */
+constexpr std::size_t kParseErrorCount = 14;
+
+
+/**
+ * @brief   Counters of a single parse stage.
+ */
+struct StageStatistics {
+    std::uint64_t count_{0};              //!< @brief Number of times the stage has been run.
+    std::uint64_t nanoseconds_{0};        //!< @brief Total time spent in the stage.
+};
+
+
+/**
+ * @brief   Aggregated parse statistics.
+ */
+struct ParseStatistics {
+    std::array<StageStatistics, kParseStageCount> stages_{};        //!< @brief Counters indexed by ParseStage.
+    std::array<std::uint64_t, kParseErrorCount> errors_{};          //!< @brief Parse results indexed by ParseError.
+    std::uint64_t parses_{0};                                       //!< @brief Number of URLs parsed.
+    std::uint64_t offset_allocations_{0};                           //!< @brief Segment/query offset allocations.
+    std::uint64_t offset_allocated_bytes_{0};                       //!< @brief Bytes of segment/query offsets.
+};
+
+
+/**
+ * @brief   Checks if the instrumentation has been compiled in.
+ * @return  true, if HEADCODE_SPACE_URL_INSTRUMENTATION is defined.
+ */
+constexpr bool IsInstrumentationEnabled() {
+#ifdef HEADCODE_SPACE_URL_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/**
+ * @brief   Returns a name of a parse stage (e.g. to label exported metrics).
+ * @param   stage       the parse stage.
+ * @return  A static string naming the stage.
+ */
+char const * GetParseStageName(ParseStage stage);
+
+
+/**
+ * @brief   Aggregates the counters of all threads (running and finished).
+ *
+ * Each thread counts into thread-local counters without any locking.
+ * Aggregation is done only on demand by this function.
+ *
+ * @return  The parse statistics so far (all zero without instrumentation).
+ */
+ParseStatistics GetParseStatistics();
+
+
+/**
+ * @brief   Resets the counters of all threads.
+ */
+void ResetParseStatistics();
+
+
+}
+
+
+#include "headcode/url/impl/instrumentation_impl.hpp"
+
+
+#endif
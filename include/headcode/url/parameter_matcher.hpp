@@ -0,0 +1,135 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_PARAMETER_MATCHER_HPP
+#define HEADCODE_SPACE_URL_PARAMETER_MATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A compiled set of query parameter names, e.g. to strip tracking parameters.
+ *
+ * The rules are exact names ("fbclid") and prefixes ("utm_*"). They are
+ * compiled into a character trie stored flat, i.e. as a single vector of
+ * nodes where the children of a node are placed next to each other sorted
+ * by character. Matching a name is a single left-to-right pass over the
+ * name without any allocation, regardless of the number of rules.
+ *
+ * Names are matched case-sensitive as given in the URL (not decoded).
+ *
+ * Example:
+ * @code
+ *      headcode::url::ParameterMatcher tracking{"utm_*\nfbclid\ngclid"};
+ *
+ *      headcode::url::URL url{"https://www.example.com/?id=1&utm_source=news&fbclid=abc#top"};
+ *      tracking.Strip(url);
+ *      std::cout << url.GetURL() << std::endl;         // <-- yields "https://www.example.com/?id=1#top"
+ * @endcode
+ */
+class ParameterMatcher {
+
+    /**
+     * @brief   A single node in the flat character trie.
+     */
+    struct Node {
+        std::uint32_t first_child_{0};         //!< @brief Index of the first child in nodes_.
+        std::uint16_t child_count_{0};         //!< @brief Number of children.
+        char character_{0};                    //!< @brief The character leading to this node.
+        std::uint8_t flags_{0};                //!< @brief Rule flags of this node.
+    };
+
+    std::vector<Node> nodes_;        //!< @brief All nodes. The root node is at index 0.
+
+public:
+    /**
+     * @brief   Ctor.
+     */
+    ParameterMatcher();
+
+    /**
+     * @brief   Ctor.
+     * @param   rules       the rules to compile (see Compile()).
+     */
+    explicit ParameterMatcher(std::string_view rules);
+
+    /**
+     * @brief   Compiles the rules.
+     *
+     * Each line holds a single rule: a parameter name or a prefix followed
+     * by a '*'. Empty lines and lines starting with "//" are ignored. Any
+     * previously compiled rules are dropped.
+     *
+     * @param   rules       the rules, one per line.
+     * @return  The number of rules compiled.
+     */
+    std::size_t Compile(std::string_view rules);
+
+    /**
+     * @brief   Returns the number of nodes in the compiled trie.
+     * @return  The number of nodes (including the root).
+     */
+    [[nodiscard]] std::size_t GetNodeCount() const {
+        return nodes_.size();
+    }
+
+    /**
+     * @brief   Checks if a parameter name matches any rule.
+     * @param   name        the parameter name.
+     * @return  true, if the name is listed or starts with a listed prefix.
+     */
+    [[nodiscard]] bool Matches(std::string_view name) const;
+
+    /**
+     * @brief   Checks if the name of a query item ("name=value" or "name") matches any rule.
+     * @param   item        the query item.
+     * @return  true, if the name of the item matches.
+     */
+    [[nodiscard]] bool MatchesItem(std::string_view item) const {
+        return Matches(item.substr(0, item.find('=')));
+    }
+
+    /**
+     * @brief   Removes all matching query items of an URL in a single pass in place.
+     * @param   url         the URL to modify.
+     * @return  The number of query items removed.
+     */
+    template <typename Policy>
+    std::size_t Strip(BasicURL<Policy> & url) const {
+        return url.RemoveQueryItems([this](std::string_view item) { return MatchesItem(item); });
+    }
+
+private:
+    /**
+     * @brief   Finds the child of a node for the given character.
+     * @param   node        the index of the parent node.
+     * @param   c           the character to search for.
+     * @return  The index of the child or 0 if not found.
+     */
+    [[nodiscard]] std::uint32_t FindChild(std::uint32_t node, char c) const;
+};
+
+
+}
+
+
+#include "headcode/url/impl/parameter_matcher_impl.hpp"
+
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_PUBLIC_SUFFIX_HPP
+#define HEADCODE_SPACE_URL_PUBLIC_SUFFIX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A compiled Public Suffix List (https://publicsuffix.org).
+ *
+ * The rules of a Public Suffix List are compiled into a reversed-label trie:
+ * the root holds the top level labels ("com", "uk", ...), their children hold
+ * the second level labels and so on. The trie is stored flat, i.e. as a single
+ * vector of nodes and a single string holding all labels. Children of a node
+ * are sorted and searched with a binary search.
+ *
+ * Lookups run in a single right-to-left pass over the host labels and do not
+ * allocate. The returned std::string_view objects point into the host passed.
+ *
+ * Example:
+ * @code
+ *      headcode::url::PublicSuffixList psl;
+ *      psl.LoadFile("/usr/share/publicsuffix/public_suffix_list.dat");
+ *
+ *      headcode::url::URL url{"https://www.example.co.uk/path"};
+ *      std::cout << psl.GetPublicSuffix(url) << std::endl;              // <-- yields "co.uk"
+ *      std::cout << psl.GetRegistrableDomain(url) << std::endl;         // <-- yields "example.co.uk"
+ * @endcode
+ *
+ * The compiled trie can be stored with Serialize() and restored with Deserialize()
+ * so that the rules need not be compiled on each startup.
+ *
+ * An empty PublicSuffixList knows only the implicit default rule "*", i.e. the
+ * last label of a host is its public suffix.
+ */
+class PublicSuffixList {
+
+    /**
+     * @brief   A single node in the flat reversed-label trie.
+     */
+    struct Node {
+        std::uint32_t label_offset_{0};        //!< @brief Start of the label in labels_.
+        std::uint32_t first_child_{0};         //!< @brief Index of the first child in nodes_.
+        std::uint32_t child_count_{0};         //!< @brief Number of children.
+        std::uint8_t label_length_{0};         //!< @brief Length of the label.
+        std::uint8_t flags_{0};                //!< @brief Rule flags of this node.
+    };
+
+    std::vector<Node> nodes_;        //!< @brief All nodes. The root node is at index 0.
+    std::string labels_;             //!< @brief All labels of all nodes.
+
+public:
+    /**
+     * @brief   Ctor.
+     */
+    PublicSuffixList();
+
+    /**
+     * @brief   Compiles the rules given in the Public Suffix List format.
+     *
+     * Each line holds a single rule. Empty lines and lines starting with "//"
+     * are ignored. Any previously compiled rules are dropped.
+     *
+     * @param   rules       the rules as found in a Public Suffix List file.
+     * @return  The number of rules compiled.
+     */
+    std::size_t Compile(std::string_view rules);
+
+    /**
+     * @brief   Deserializes a previously serialized (compiled) list.
+     * @param   data        the data as returned by Serialize().
+     * @return  true, if the data has been valid and loaded.
+     */
+    bool Deserialize(std::string_view data);
+
+    /**
+     * @brief   Returns the public suffix of a host.
+     * @param   host        the host to check.
+     * @return  The public suffix found inside host (empty for IP addresses or bad hosts).
+     */
+    [[nodiscard]] std::string_view GetPublicSuffix(std::string_view host) const;
+
+    /**
+     * @brief   Returns the public suffix of the host of an URL.
+     * @param   url         the url to check.
+     * @return  The public suffix found inside the host of the url.
+     */
+    [[nodiscard]] std::string_view GetPublicSuffix(URL const & url) const {
+        return GetPublicSuffix(url.GetHost());
+    }
+
+    /**
+     * @brief   Returns the registrable domain (eTLD+1) of a host.
+     * @param   host        the host to check.
+     * @return  The registrable domain found inside host (empty if the host is a public suffix itself).
+     */
+    [[nodiscard]] std::string_view GetRegistrableDomain(std::string_view host) const;
+
+    /**
+     * @brief   Returns the registrable domain (eTLD+1) of the host of an URL.
+     * @param   url         the url to check.
+     * @return  The registrable domain found inside the host of the url.
+     */
+    [[nodiscard]] std::string_view GetRegistrableDomain(URL const & url) const {
+        return GetRegistrableDomain(url.GetHost());
+    }
+
+    /**
+     * @brief   Returns the number of nodes in the compiled trie.
+     * @return  The number of nodes (including the root).
+     */
+    [[nodiscard]] std::size_t GetNodeCount() const {
+        return nodes_.size();
+    }
+
+    /**
+     * @brief   Loads and compiles a Public Suffix List file.
+     * @param   file_name       the path to the Public Suffix List file.
+     * @return  true, if the file could be read.
+     */
+    bool LoadFile(std::string const & file_name);
+
+    /**
+     * @brief   Serializes the compiled list.
+     * @return  A binary blob which can be passed to Deserialize().
+     */
+    [[nodiscard]] std::string Serialize() const;
+
+private:
+    /**
+     * @brief   Finds the child of a node holding the given label.
+     * @param   node        the index of the parent node.
+     * @param   label       the label to search for (case-insensitive).
+     * @return  The index of the child or 0 if not found.
+     */
+    [[nodiscard]] std::uint32_t FindChild(std::uint32_t node, std::string_view label) const;
+
+    /**
+     * @brief   Returns the start of the public suffix in host.
+     * @param   host        the host to check (without trailing '.').
+     * @return  The start index of the public suffix in host or std::string_view::npos.
+     */
+    [[nodiscard]] std::size_t FindPublicSuffix(std::string_view host) const;
+};
+
+
+}
+
+
+#include "headcode/url/impl/public_suffix_impl.hpp"
+
+
+#endif
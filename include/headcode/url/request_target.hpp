@@ -0,0 +1,250 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_REQUEST_TARGET_HPP
+#define HEADCODE_SPACE_URL_REQUEST_TARGET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   The forms of an HTTP request-target (RFC 7230 5.3).
+ */
+enum class RequestTargetForm {
+    kOrigin = 0,        //!< @brief absolute-path [ "?" query ], e.g. "/where?q=now".
+    kAbsolute,          //!< @brief absolute-URI, e.g. "http://www.example.org/pub/WWW/" (proxies).
+    kAuthority,         //!< @brief authority, e.g. "www.example.com:80" (CONNECT only).
+    kAsterisk           //!< @brief "*" (server wide OPTIONS).
+};
+
+
+/**
+ * @brief   A parsed HTTP request-target (RFC 7230 5.3).
+ *
+ * The target is parsed in place with the very same stages as an URL:
+ * nothing is copied and nothing is allocated. All components are views into
+ * the target passed, which must outlive this object.
+ *
+ * The form is told by the first character: '/' is origin-form, "*" is
+ * asterisk-form and anything else is absolute-form. The authority-form
+ * "host:port" cannot be told from an absolute-URI with the scheme "host":
+ * it is parsed only for CONNECT requests, which in turn allow nothing else.
+ *
+ * A request-target never holds a fragment: a '#' is an error.
+ *
+ * Example:
+ * @code
+ *      headcode::url::RequestTarget target{"/search?q=url"};
+ *      if (target.IsValid()) {
+ *          std::cout << target.GetPath() << std::endl;            // <-- yields "/search"
+ *          std::cout << target.GetQuery() << std::endl;           // <-- yields "q=url"
+ *      }
+ *
+ *      headcode::url::RequestTarget tunnel{"www.example.com:443", true};
+ *      std::cout << tunnel.GetPortNumber() << std::endl;          // <-- yields 443
+ * @endcode
+ */
+class RequestTarget {
+
+    std::string_view target_;                                           //!< @brief The target parsed.
+    ParseError error_{ParseError::kURLEmpty};                           //!< @brief Parse result.
+    RequestTargetForm form_{RequestTargetForm::kOrigin};                //!< @brief The form of the target.
+    std::pair<std::size_t, std::size_t> scheme_{0, 0};                  //!< @brief The scheme (absolute-form).
+    SchemeKind scheme_kind_{SchemeKind::kUnknown};                      //!< @brief The well known scheme.
+    std::pair<std::size_t, std::size_t> authority_{0, 0};               //!< @brief The authority.
+    std::pair<std::size_t, std::size_t> userinfo_{0, 0};                //!< @brief The userinfo.
+    std::pair<std::size_t, std::size_t> host_{0, 0};                    //!< @brief The host.
+    HostAddress host_address_;                                          //!< @brief The type and address of the host.
+    std::pair<std::size_t, std::size_t> port_{0, 0};                    //!< @brief The port.
+    std::uint16_t port_number_{0};                                      //!< @brief The numeric value of the port.
+    std::pair<std::size_t, std::size_t> path_{0, 0};                    //!< @brief The path.
+    std::pair<std::size_t, std::size_t> query_{0, 0};                   //!< @brief The query.
+    bool query_present_{false};                                         //!< @brief Flag for a '?'.
+
+public:
+    /**
+     * @brief   Ctor.
+     */
+    RequestTarget() = default;
+
+    /**
+     * @brief   Ctor.
+     * @param   target      the request-target of the request line (not copied).
+     * @param   connect     the request method is CONNECT (authority-form).
+     * @param   limits      the limits to enforce.
+     */
+    explicit RequestTarget(std::string_view target, bool connect = false, ParseLimits const & limits = {}) {
+        Assign(target, connect, limits);
+    }
+
+    /**
+     * @brief   Parses a new request-target.
+     * @param   target      the request-target of the request line (not copied).
+     * @param   connect     the request method is CONNECT (authority-form).
+     * @param   limits      the limits to enforce.
+     */
+    void Assign(std::string_view target, bool connect = false, ParseLimits const & limits = {});
+
+    /**
+     * @brief   Returns the authority (absolute- and authority-form).
+     * @return  The authority.
+     */
+    [[nodiscard]] std::string_view GetAuthority() const {
+        return target_.substr(authority_.first, authority_.second);
+    }
+
+    /**
+     * @brief   Returns the parse result.
+     * @return  ParseError::kNoError, if the target is valid.
+     */
+    [[nodiscard]] ParseError GetError() const {
+        return error_;
+    }
+
+    /**
+     * @brief   Returns the form of the target.
+     * @return  The form of the target.
+     */
+    [[nodiscard]] RequestTargetForm GetForm() const {
+        return form_;
+    }
+
+    /**
+     * @brief   Returns the host (absolute- and authority-form).
+     * @return  The host (IP literals without '[' and ']').
+     */
+    [[nodiscard]] std::string_view GetHost() const {
+        return target_.substr(host_.first, host_.second);
+    }
+
+    /**
+     * @brief   Returns the type and binary address of the host.
+     * @return  The host address.
+     */
+    [[nodiscard]] HostAddress const & GetHostAddress() const {
+        return host_address_;
+    }
+
+    /**
+     * @brief   Returns the path (origin- and absolute-form).
+     * @return  The path.
+     */
+    [[nodiscard]] std::string_view GetPath() const {
+        return target_.substr(path_.first, path_.second);
+    }
+
+    /**
+     * @brief   Returns the port.
+     * @return  The port.
+     */
+    [[nodiscard]] std::string_view GetPort() const {
+        return target_.substr(port_.first, port_.second);
+    }
+
+    /**
+     * @brief   Returns the port as number.
+     * @return  The port number (0 if none).
+     */
+    [[nodiscard]] std::uint16_t GetPortNumber() const {
+        return port_number_;
+    }
+
+    /**
+     * @brief   Returns the query (without the '?').
+     * @return  The query.
+     */
+    [[nodiscard]] std::string_view GetQuery() const {
+        return target_.substr(query_.first, query_.second);
+    }
+
+    /**
+     * @brief   Returns the scheme (absolute-form).
+     * @return  The scheme.
+     */
+    [[nodiscard]] std::string_view GetScheme() const {
+        return target_.substr(scheme_.first, scheme_.second);
+    }
+
+    /**
+     * @brief   Returns the well known scheme (absolute-form).
+     * @return  The kind of the scheme.
+     */
+    [[nodiscard]] SchemeKind GetSchemeKind() const {
+        return scheme_kind_;
+    }
+
+    /**
+     * @brief   Returns the target parsed.
+     * @return  The target as passed.
+     */
+    [[nodiscard]] std::string_view GetTarget() const {
+        return target_;
+    }
+
+    /**
+     * @brief   Returns the userinfo (absolute-form).
+     * @return  The userinfo.
+     */
+    [[nodiscard]] std::string_view GetUserInfo() const {
+        return target_.substr(userinfo_.first, userinfo_.second);
+    }
+
+    /**
+     * @brief   States if the target has a query (at least a '?').
+     * @return  true, if there is a '?'.
+     */
+    [[nodiscard]] bool IsQueryPresent() const {
+        return query_present_;
+    }
+
+    /**
+     * @brief   Checks if the target has been parsed successfully.
+     * @return  true, if the target is valid.
+     */
+    [[nodiscard]] bool IsValid() const {
+        return error_ == ParseError::kNoError;
+    }
+
+private:
+    /**
+     * @brief   Parses the target in its form.
+     * @param   connect     the request method is CONNECT (authority-form).
+     * @param   limits      the limits to enforce.
+     * @return  ParseError value.
+     */
+    ParseError Parse(bool connect, ParseLimits const & limits);
+
+    /**
+     * @brief   Parses the path and the query starting at a position up to the end of the target.
+     * @param   start               the start of the path.
+     * @param   authority_present   the path follows an authority.
+     * @param   limits              the limits to enforce.
+     * @return  ParseError value.
+     */
+    ParseError ParsePathAndQuery(std::size_t start, bool authority_present, ParseLimits const & limits);
+};
+
+
+}
+
+
+#include "headcode/url/impl/request_target_impl.hpp"
+
+
+#endif
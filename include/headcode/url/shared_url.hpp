@@ -0,0 +1,175 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_SHARED_URL_HPP
+#define HEADCODE_SPACE_URL_SHARED_URL_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A parsed URL shared immutably between copies.
+ *
+ * A BasicURL holds the URL string plus the offset vectors of the path
+ * segments and query items: copying it copies all of them. A SharedURL
+ * holds the parsed URL in a single atomically reference counted block,
+ * so a copy is just a reference count increment and parsed URLs can be
+ * handed through queues and stored in several indexes without copying.
+ *
+ * The shared URL is never modified. Mutable() detaches a private copy
+ * first, if the URL is shared (copy on write). Hence different threads
+ * may read and copy their own SharedURL objects referring to the same
+ * URL without any locking. Once the other copies are gone (in whatever
+ * thread) Mutable() modifies the URL in place: an acquire fence orders
+ * this after everything done with the released copies. As with
+ * std::shared_ptr a single SharedURL object must not be modified by one
+ * thread while used by another.
+ *
+ * @tparam  Policy      the parse policy of the URL.
+ */
+template <typename Policy = DefaultURLPolicy>
+class BasicSharedURL {
+
+    std::shared_ptr<BasicURL<Policy>> url_;        //!< @brief The shared URL (modified only if not shared).
+
+public:
+    /**
+     * @brief   Ctor. Refers to the shared empty URL (no allocation).
+     */
+    BasicSharedURL();
+
+    /**
+     * @brief   Ctor. Parses an URL.
+     * @param   url         the URL string to parse.
+     */
+    explicit BasicSharedURL(std::string url) : url_{std::make_shared<BasicURL<Policy>>(std::move(url))} {
+    }
+
+    /**
+     * @brief   Ctor. Parses an URL with limits.
+     * @param   url         the URL string to parse.
+     * @param   limits      the limits to apply while parsing.
+     */
+    BasicSharedURL(std::string url, ParseLimits const & limits)
+        : url_{std::make_shared<BasicURL<Policy>>(std::move(url), limits)} {
+    }
+
+    /**
+     * @brief   Ctor. Parses a trusted URL.
+     * @param   url         the URL string to parse (must be valid).
+     */
+    BasicSharedURL(std::string url, TrustedInput)
+        : url_{std::make_shared<BasicURL<Policy>>(std::move(url), kTrustedInput)} {
+    }
+
+    /**
+     * @brief   Ctor. Takes over an already parsed URL.
+     * @param   url         the parsed URL.
+     */
+    explicit BasicSharedURL(BasicURL<Policy> url) : url_{std::make_shared<BasicURL<Policy>>(std::move(url))} {
+    }
+
+    /**
+     * @brief   Copy Ctor. Shares the URL.
+     */
+    BasicSharedURL(BasicSharedURL const &) = default;
+
+    /**
+     * @brief   Move Ctor.
+     */
+    BasicSharedURL(BasicSharedURL &&) noexcept = default;
+
+    /**
+     * @brief   Dtor.
+     */
+    ~BasicSharedURL() = default;
+
+    /**
+     * @brief   Assignment. Shares the URL.
+     * @return  this.
+     */
+    BasicSharedURL & operator=(BasicSharedURL const &) = default;
+
+    /**
+     * @brief   Move Assignment.
+     * @return  this.
+     */
+    BasicSharedURL & operator=(BasicSharedURL &&) noexcept = default;
+
+    /**
+     * @brief   Returns the parsed URL.
+     * @return  The shared URL.
+     */
+    [[nodiscard]] BasicURL<Policy> const & Get() const {
+        return *url_;
+    }
+
+    /**
+     * @brief   Returns the number of SharedURL objects referring to this URL.
+     * @return  The number of references (a snapshot only if other threads copy).
+     */
+    [[nodiscard]] long GetUseCount() const {
+        return url_.use_count();
+    }
+
+    /**
+     * @brief   Checks if the URL is referred to by other SharedURL objects, too.
+     * @return  true, if the URL is shared.
+     */
+    [[nodiscard]] bool IsShared() const {
+        return url_.use_count() > 1;
+    }
+
+    /**
+     * @brief   Returns the URL for modification, copying it first if it is shared.
+     * The reference is valid until this object is copied or modified.
+     * @return  The URL owned by this object only.
+     */
+    BasicURL<Policy> & Mutable();
+
+    /**
+     * @brief   Returns the parsed URL.
+     * @return  The shared URL.
+     */
+    BasicURL<Policy> const & operator*() const {
+        return *url_;
+    }
+
+    /**
+     * @brief   Accesses the parsed URL.
+     * @return  The shared URL.
+     */
+    BasicURL<Policy> const * operator->() const {
+        return url_.get();
+    }
+};
+
+
+/**
+ * @brief   The shared URL with the default parse policy.
+ */
+using SharedURL = BasicSharedURL<DefaultURLPolicy>;
+
+
+}
+
+
+#include "headcode/url/impl/shared_url_impl.hpp"
+
+
+#endif
@@ -11,6 +11,18 @@
 
 
 #include "url_core.hpp"
+#include "cache_key.hpp"
+#include "instrumentation.hpp"
+#include "parameter_matcher.hpp"
+#include "public_suffix.hpp"
+#include "request_target.hpp"
+#include "shared_url.hpp"
+#include "url_cache.hpp"
+#include "url_columns.hpp"
+#include "url_record.hpp"
+#include "url_scanner.hpp"
+#include "url_stream_parser.hpp"
+#include "url_visitor.hpp"
 #include "version.hpp"
 
 
@@ -0,0 +1,156 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_CACHE_HPP
+#define HEADCODE_SPACE_URL_URL_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "shared_url.hpp"
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   Counters of an URL cache.
+ */
+struct URLCacheStatistics {
+    std::uint64_t hits_{0};             //!< @brief Lookups answered from the cache.
+    std::uint64_t misses_{0};           //!< @brief Lookups which parsed the URL.
+    std::uint64_t evictions_{0};        //!< @brief Entries dropped to make room.
+    std::size_t size_{0};               //!< @brief Entries currently held.
+};
+
+
+/**
+ * @brief   A concurrent cache of parsed URLs keyed by the raw URL string.
+ *
+ * Heavily skewed traffic repeats the same URLs over and over. The cache
+ * parses an URL only once and hands out the very same parsed URL as
+ * SharedURL on each following lookup: no parsing, no copying.
+ *
+ * The cache is split into shards, each guarded by its own mutex; the
+ * shard is picked by the hash of the URL. Hence lookups of different URLs
+ * rarely contend. Parsing on a miss is done outside of any lock.
+ *
+ * Each shard holds at most capacity / shards entries (rounded up) and
+ * evicts with the CLOCK algorithm: an entry looked up since the clock
+ * hand passed last survives the next pass. Memory is bounded by the
+ * number of entries times the URL size; ParseLimits bound the latter:
+ * an URL longer than max_length_ is rejected with ParseError::kURLTooLong
+ * before it is copied and is never cached. Other invalid URLs are cached as
+ * well (with their error).
+ *
+ * @tparam  Policy      the parse policy of the URLs.
+ */
+template <typename Policy = DefaultURLPolicy>
+class BasicURLCache {
+
+    /**
+     * @brief   A cached URL.
+     */
+    struct Entry {
+        BasicSharedURL<Policy> url_;        //!< @brief The parsed URL (holds the key string, too).
+        bool referenced_{false};            //!< @brief Looked up since the clock hand passed last.
+    };
+
+    /**
+     * @brief   A part of the cache with its own lock (on its own cache line).
+     */
+    struct alignas(64) Shard {
+        std::mutex mutex_;                                              //!< @brief Guards the shard.
+        std::unordered_map<std::string_view, std::size_t> index_;        //!< @brief URL string to entry.
+        std::vector<Entry> entries_;                                    //!< @brief The entries (the clock).
+        std::size_t hand_{0};                                           //!< @brief The clock hand.
+        std::uint64_t hits_{0};                                         //!< @brief Hits of this shard.
+        std::uint64_t misses_{0};                                       //!< @brief Misses of this shard.
+        std::uint64_t evictions_{0};                                    //!< @brief Evictions of this shard.
+    };
+
+    std::vector<Shard> shards_;             //!< @brief The shards.
+    std::size_t shard_capacity_;            //!< @brief Maximum number of entries per shard.
+    ParseLimits limits_;                    //!< @brief The limits applied to parse an URL.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   capacity    maximum number of URLs to cache (0 disables caching).
+     * @param   shards      number of shards (at least 1).
+     * @param   limits      the limits applied to parse an URL.
+     */
+    explicit BasicURLCache(std::size_t capacity, std::size_t shards = 16, ParseLimits const & limits = {});
+
+    /**
+     * @brief   Copy Ctor.
+     */
+    BasicURLCache(BasicURLCache const &) = delete;
+
+    /**
+     * @brief   Assignment.
+     */
+    BasicURLCache & operator=(BasicURLCache const &) = delete;
+
+    /**
+     * @brief   Drops all entries (the counters are kept).
+     */
+    void Clear();
+
+    /**
+     * @brief   Returns the parsed URL, parsing and caching it on a miss.
+     * @param   url         the URL string.
+     * @return  The parsed URL shared with the cache (an uncached kURLTooLong result if too long).
+     */
+    [[nodiscard]] BasicSharedURL<Policy> Get(std::string_view url);
+
+    /**
+     * @brief   Returns the maximum number of URLs cached.
+     * @return  The capacity of all shards.
+     */
+    [[nodiscard]] std::size_t GetCapacity() const {
+        return shard_capacity_ * shards_.size();
+    }
+
+    /**
+     * @brief   Collects the counters of all shards.
+     * @return  The cache statistics.
+     */
+    [[nodiscard]] URLCacheStatistics GetStatistics();
+
+private:
+    /**
+     * @brief   Inserts a parsed URL into a locked shard, evicting an entry if full.
+     * @param   shard       the locked shard.
+     * @param   url         the parsed URL.
+     */
+    void Insert(Shard & shard, BasicSharedURL<Policy> const & url);
+};
+
+
+/**
+ * @brief   The URL cache with the default parse policy.
+ */
+using URLCache = BasicURLCache<DefaultURLPolicy>;
+
+
+}
+
+
+#include "headcode/url/impl/url_cache_impl.hpp"
+
+
+#endif
@@ -0,0 +1,332 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_COLUMNS_HPP
+#define HEADCODE_SPACE_URL_URL_COLUMNS_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A dictionary assigning consecutive ids to distinct strings.
+ *
+ * All strings are stored back to back in a single string, the lookup
+ * is an open addressing hash table of ids. There is no allocation per
+ * entry besides the growth of these containers.
+ */
+class StringDictionary {
+
+    std::string data_;                           //!< @brief All strings back to back.
+    std::vector<std::size_t> offsets_{0};        //!< @brief Start of each string in data_ (plus end).
+    std::vector<std::uint32_t> slots_;           //!< @brief Hash table holding id + 1 (0 for empty).
+
+public:
+    /**
+     * @brief   Value returned by Find() for strings not present.
+     */
+    static constexpr std::uint32_t kNotFound = 0xffffffff;
+
+    /**
+     * @brief   Removes all strings.
+     */
+    void Clear();
+
+    /**
+     * @brief   Searches for a string.
+     * @param   value       the string to search for.
+     * @return  The id of the string or kNotFound.
+     */
+    [[nodiscard]] std::uint32_t Find(std::string_view value) const;
+
+    /**
+     * @brief   Returns the string of an id.
+     * @param   id          the id of the string (must be less than Size()).
+     * @return  The string with this id.
+     */
+    [[nodiscard]] std::string_view Get(std::uint32_t id) const {
+        return std::string_view{data_}.substr(offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+
+    /**
+     * @brief   Returns the id of a string and adds it if not yet present.
+     * @param   value       the string to add.
+     * @return  The id of the string.
+     */
+    std::uint32_t Insert(std::string_view value);
+
+    /**
+     * @brief   Returns the number of distinct strings.
+     * @return  The number of distinct strings.
+     */
+    [[nodiscard]] std::size_t Size() const {
+        return offsets_.size() - 1;
+    }
+
+private:
+    /**
+     * @brief   Returns the slot holding value or the empty slot to place it.
+     * @param   value       the string to search for.
+     * @return  Index into slots_.
+     */
+    [[nodiscard]] std::size_t FindSlot(std::string_view value) const;
+
+    /**
+     * @brief   Doubles the hash table and reinserts all ids.
+     */
+    void Grow();
+};
+
+
+/**
+ * @brief   URLs parsed into a columnar layout.
+ *
+ * In place of an array of URL objects, the components of each URL are
+ * appended to columns:
+ *
+ *      - scheme and host are dictionary encoded: the column holds an id per
+ *        row, each distinct value is stored once in a StringDictionary,
+ *      - path, query and fragment are stored back to back in a single
+ *        string each along with an offset column,
+ *      - the parse error and the presence flags of query and fragment get
+ *        a column each.
+ *
+ * This suits analytics: e.g. "count by host" runs over the host id column
+ * and filtering on paths runs over a single contiguous string.
+ *
+ * Example:
+ * @code
+ *      headcode::url::URLColumns columns;
+ *      for (auto const & line : log_lines) {
+ *          columns.Append(line);
+ *      }
+ *
+ *      std::vector<std::size_t> count_by_host(columns.GetHosts().Size());
+ *      for (auto id : columns.GetHostIds()) {
+ *          count_by_host[id]++;
+ *      }
+ * @endcode
+ *
+ * Invalid URLs are appended too, with the components found until the
+ * error (usually empty) and the error in the error column.
+ */
+class URLColumns {
+
+    /**
+     * @brief   A string column: all values back to back plus the offsets.
+     */
+    struct BlobColumn {
+        std::string data_;                           //!< @brief All values back to back.
+        std::vector<std::size_t> offsets_{0};        //!< @brief Start of each value in data_ (plus end).
+    };
+
+    StringDictionary schemes_;                      //!< @brief Distinct schemes.
+    std::vector<std::uint32_t> scheme_ids_;         //!< @brief Scheme id per row.
+    StringDictionary hosts_;                        //!< @brief Distinct hosts.
+    std::vector<std::uint32_t> host_ids_;           //!< @brief Host id per row.
+    BlobColumn paths_;                              //!< @brief Path per row.
+    BlobColumn queries_;                            //!< @brief Query per row.
+    BlobColumn fragments_;                          //!< @brief Fragment per row.
+    std::vector<ParseError> errors_;                //!< @brief Parse error per row.
+    std::vector<std::uint8_t> flags_;               //!< @brief Query and fragment presence flags per row.
+
+public:
+    /**
+     * @brief   Row flag: a query is present.
+     */
+    static constexpr std::uint8_t kQueryPresent = 0x01;
+
+    /**
+     * @brief   Row flag: a fragment is present.
+     */
+    static constexpr std::uint8_t kFragmentPresent = 0x02;
+
+    /**
+     * @brief   Appends a parsed URL as new row.
+     * @param   url         the URL to append.
+     */
+    void Append(URL const & url);
+
+    /**
+     * @brief   Parses an URL and appends it as new row.
+     * @param   url         the URL to parse and append.
+     */
+    void Append(std::string_view url) {
+        Append(URL{std::string{url}});
+    }
+
+    /**
+     * @brief   Removes all rows.
+     */
+    void Clear();
+
+    /**
+     * @brief   Returns the parse error of a row.
+     * @param   row         the row.
+     * @return  The error encountered parsing the URL of this row.
+     */
+    [[nodiscard]] ParseError GetError(std::size_t row) const {
+        return errors_[row];
+    }
+
+    /**
+     * @brief   Returns the parse error column.
+     * @return  The parse error of all rows.
+     */
+    [[nodiscard]] std::vector<ParseError> const & GetErrors() const {
+        return errors_;
+    }
+
+    /**
+     * @brief   Returns the presence flags column.
+     * @return  The presence flags (kQueryPresent, kFragmentPresent) of all rows.
+     */
+    [[nodiscard]] std::vector<std::uint8_t> const & GetFlags() const {
+        return flags_;
+    }
+
+    /**
+     * @brief   Returns the fragment of a row.
+     * @param   row         the row.
+     * @return  The fragment of the URL of this row.
+     */
+    [[nodiscard]] std::string_view GetFragment(std::size_t row) const {
+        return Get(fragments_, row);
+    }
+
+    /**
+     * @brief   Returns the host of a row.
+     * @param   row         the row.
+     * @return  The host of the URL of this row.
+     */
+    [[nodiscard]] std::string_view GetHost(std::size_t row) const {
+        return hosts_.Get(host_ids_[row]);
+    }
+
+    /**
+     * @brief   Returns the host id column.
+     * @return  The host id of all rows (ids into GetHosts()).
+     */
+    [[nodiscard]] std::vector<std::uint32_t> const & GetHostIds() const {
+        return host_ids_;
+    }
+
+    /**
+     * @brief   Returns the host dictionary.
+     * @return  The distinct hosts.
+     */
+    [[nodiscard]] StringDictionary const & GetHosts() const {
+        return hosts_;
+    }
+
+    /**
+     * @brief   Returns the path of a row.
+     * @param   row         the row.
+     * @return  The path of the URL of this row.
+     */
+    [[nodiscard]] std::string_view GetPath(std::size_t row) const {
+        return Get(paths_, row);
+    }
+
+    /**
+     * @brief   Returns the query of a row.
+     * @param   row         the row.
+     * @return  The query of the URL of this row.
+     */
+    [[nodiscard]] std::string_view GetQuery(std::size_t row) const {
+        return Get(queries_, row);
+    }
+
+    /**
+     * @brief   Returns the scheme of a row.
+     * @param   row         the row.
+     * @return  The scheme of the URL of this row.
+     */
+    [[nodiscard]] std::string_view GetScheme(std::size_t row) const {
+        return schemes_.Get(scheme_ids_[row]);
+    }
+
+    /**
+     * @brief   Returns the scheme id column.
+     * @return  The scheme id of all rows (ids into GetSchemes()).
+     */
+    [[nodiscard]] std::vector<std::uint32_t> const & GetSchemeIds() const {
+        return scheme_ids_;
+    }
+
+    /**
+     * @brief   Returns the scheme dictionary.
+     * @return  The distinct schemes.
+     */
+    [[nodiscard]] StringDictionary const & GetSchemes() const {
+        return schemes_;
+    }
+
+    /**
+     * @brief   States if the URL of a row has a fragment.
+     * @param   row         the row.
+     * @return  True, if there is a '#'.
+     */
+    [[nodiscard]] bool IsFragmentPresent(std::size_t row) const {
+        return flags_[row] & kFragmentPresent;
+    }
+
+    /**
+     * @brief   States if the URL of a row has a query.
+     * @param   row         the row.
+     * @return  True, if there is a '?'.
+     */
+    [[nodiscard]] bool IsQueryPresent(std::size_t row) const {
+        return flags_[row] & kQueryPresent;
+    }
+
+    /**
+     * @brief   Reserves memory for a number of rows.
+     * @param   rows        the number of rows expected.
+     */
+    void Reserve(std::size_t rows);
+
+    /**
+     * @brief   Returns the number of rows.
+     * @return  The number of URLs appended.
+     */
+    [[nodiscard]] std::size_t Size() const {
+        return errors_.size();
+    }
+
+private:
+    /**
+     * @brief   Returns a value of a string column.
+     * @param   column      the column.
+     * @param   row         the row.
+     * @return  The value of the column in this row.
+     */
+    [[nodiscard]] static std::string_view Get(BlobColumn const & column, std::size_t row) {
+        return std::string_view{column.data_}.substr(column.offsets_[row],
+                                                     column.offsets_[row + 1] - column.offsets_[row]);
+    }
+};
+
+
+}
+
+
+#include "headcode/url/impl/url_columns_impl.hpp"
+
+
+#endif
@@ -9,10 +9,16 @@
 #ifndef HEADCODE_SPACE_URL_URL_CORE_HPP
 #define HEADCODE_SPACE_URL_URL_CORE_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
-#include <utility>
+
+#include "instrumentation.hpp"
 
 
 /**
@@ -35,12 +41,511 @@ enum class ParseError {
     kInvalidPort,              //!< @brief Port part in URL is invalid.
     kInvalidPath,              //!< @brief Path part in URL is invalid.
     kInvalidQuery,             //!< @brief Query part in URL is invalid.
-    kInvalidFragment           //!< @brief Fragment part in URL is invalid.
+    kInvalidFragment,          //!< @brief Fragment part in URL is invalid.
+    kURLTooLong,               //!< @brief The URL exceeds ParseLimits::max_length_.
+    kTooManySegments,          //!< @brief The path exceeds ParseLimits::max_segments_.
+    kTooManyQueryItems         //!< @brief The query exceeds ParseLimits::max_query_items_.
+};
+
+
+static_assert(static_cast<std::size_t>(ParseError::kTooManyQueryItems) + 1 == kParseErrorCount,
+              "kParseErrorCount does not match ParseError.");
+
+
+/**
+ * @brief   Limits applied while parsing.
+ *
+ * Parsing is linear in the length of the URL. These limits let a caller
+ * facing untrusted input reject oversized URLs early: the length is checked
+ * before parsing starts, segments and query items as soon as the limit is hit.
+ * The defaults impose no limits.
+ */
+struct ParseLimits {
+    std::size_t max_length_{static_cast<std::size_t>(-1)};             //!< @brief Maximum length of the URL.
+    std::size_t max_segments_{static_cast<std::size_t>(-1)};           //!< @brief Maximum number of path segments.
+    std::size_t max_query_items_{static_cast<std::size_t>(-1)};        //!< @brief Maximum number of query items.
+};
+
+
+/**
+ * @brief Well known schemes identified while parsing.
+ */
+enum class SchemeKind {
+    kUnknown = 0,        //!< @brief Any other (or no) scheme.
+    kData,               //!< @brief "data" scheme.
+    kFile,               //!< @brief "file" scheme.
+    kFtp,                //!< @brief "ftp" scheme.
+    kHttp,               //!< @brief "http" scheme.
+    kHttps,              //!< @brief "https" scheme.
+    kMailto,             //!< @brief "mailto" scheme.
+    kWs,                 //!< @brief "ws" scheme.
+    kWss                 //!< @brief "wss" scheme.
+};
+
+
+/**
+ * @brief The different kinds of hosts in an URL.
+ */
+enum class HostType {
+    kNone = 0,         //!< @brief No host present (no authority in the URL).
+    kRegName,          //!< @brief Host is a registered name (may be empty).
+    kIPv4,             //!< @brief Host is an IPv4 address.
+    kIPv6,             //!< @brief Host is an IPv6 address (enclosed in '[' and ']' in the URL).
+    kIPvFuture         //!< @brief Host is an IPvFuture address (enclosed in '[' and ']' in the URL).
+};
+
+
+/**
+ * @brief The host of an URL in binary form, as identified while parsing.
+ */
+struct HostAddress {
+    HostType type_{HostType::kNone};             //!< @brief The kind of host.
+    std::uint32_t ipv4_{0};                      //!< @brief The IPv4 address in host byte order (if kIPv4).
+    std::array<std::uint8_t, 16> ipv6_{};        //!< @brief The IPv6 address in network byte order (if kIPv6).
+};
+
+
+/**
+ * @brief   A view on the parsed path segments or query items of an URL.
+ *
+ * The range refers to the offsets stored in the URL object and yields each
+ * item as std::string_view into the URL string. It never allocates and is
+ * valid as long as the URL object is not modified or destroyed.
+ */
+class OffsetRange {
+
+    char const * url_{nullptr};                                //!< @brief The URL string.
+    std::pair<std::size_t, std::size_t> const * begin_{nullptr};        //!< @brief First offset pair.
+    std::pair<std::size_t, std::size_t> const * end_{nullptr};          //!< @brief Past the last offset pair.
+
+public:
+    /**
+     * @brief   Random access iterator over the items of an OffsetRange.
+     */
+    class Iterator {
+
+        char const * url_{nullptr};                                  //!< @brief The URL string.
+        std::pair<std::size_t, std::size_t> const * offset_{nullptr};        //!< @brief Current offset pair.
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;        //!< @brief Iterator category.
+        using value_type = std::string_view;                               //!< @brief Items are string views.
+        using difference_type = std::ptrdiff_t;                            //!< @brief Iterator distance.
+        using pointer = void;                                              //!< @brief Items are values only.
+        using reference = std::string_view;                                //!< @brief Items are returned by value.
+
+        /**
+         * @brief   Ctor.
+         */
+        Iterator() = default;
+
+        /**
+         * @brief   Ctor.
+         * @param   url         the URL string.
+         * @param   offset      the offset pair to point to.
+         */
+        Iterator(char const * url, std::pair<std::size_t, std::size_t> const * offset) : url_{url}, offset_{offset} {
+        }
+
+        /**
+         * @brief   Returns the current item.
+         * @return  The item.
+         */
+        std::string_view operator*() const {
+            return std::string_view{url_ + offset_->first, offset_->second};
+        }
+
+        /**
+         * @brief   Returns the item n positions ahead.
+         * @return  The item.
+         */
+        std::string_view operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        /**
+         * @brief   Advances to the next item.
+         * @return  this.
+         */
+        Iterator & operator++() {
+            ++offset_;
+            return *this;
+        }
+
+        /**
+         * @brief   Advances to the next item.
+         * @return  The iterator before advancing.
+         */
+        Iterator operator++(int) {
+            auto result = *this;
+            ++offset_;
+            return result;
+        }
+
+        /**
+         * @brief   Steps back to the previous item.
+         * @return  this.
+         */
+        Iterator & operator--() {
+            --offset_;
+            return *this;
+        }
+
+        /**
+         * @brief   Steps back to the previous item.
+         * @return  The iterator before stepping back.
+         */
+        Iterator operator--(int) {
+            auto result = *this;
+            --offset_;
+            return result;
+        }
+
+        /**
+         * @brief   Advances n items.
+         * @return  this.
+         */
+        Iterator & operator+=(difference_type n) {
+            offset_ += n;
+            return *this;
+        }
+
+        /**
+         * @brief   Steps back n items.
+         * @return  this.
+         */
+        Iterator & operator-=(difference_type n) {
+            offset_ -= n;
+            return *this;
+        }
+
+        /**
+         * @brief   Advances n items.
+         * @return  The advanced iterator.
+         */
+        friend Iterator operator+(Iterator it, difference_type n) {
+            return it += n;
+        }
+
+        /**
+         * @brief   Advances n items.
+         * @return  The advanced iterator.
+         */
+        friend Iterator operator+(difference_type n, Iterator it) {
+            return it += n;
+        }
+
+        /**
+         * @brief   Steps back n items.
+         * @return  The iterator stepped back.
+         */
+        friend Iterator operator-(Iterator it, difference_type n) {
+            return it -= n;
+        }
+
+        /**
+         * @brief   Distance of two iterators.
+         * @return  The number of items from rhs to lhs.
+         */
+        friend difference_type operator-(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ - rhs.offset_;
+        }
+
+        // comparisons
+
+        friend bool operator==(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ == rhs.offset_;
+        }
+
+        friend bool operator!=(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ != rhs.offset_;
+        }
+
+        friend bool operator<(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ < rhs.offset_;
+        }
+
+        friend bool operator<=(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ <= rhs.offset_;
+        }
+
+        friend bool operator>(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ > rhs.offset_;
+        }
+
+        friend bool operator>=(Iterator const & lhs, Iterator const & rhs) {
+            return lhs.offset_ >= rhs.offset_;
+        }
+    };
+
+    using iterator = Iterator;                                           //!< @brief The iterator.
+    using const_iterator = Iterator;                                     //!< @brief The (same) const iterator.
+    using reverse_iterator = std::reverse_iterator<Iterator>;            //!< @brief The reverse iterator.
+    using const_reverse_iterator = std::reverse_iterator<Iterator>;      //!< @brief The const reverse iterator.
+    using value_type = std::string_view;                                 //!< @brief Items are string views.
+    using size_type = std::size_t;                                       //!< @brief Size of the range.
+
+    /**
+     * @brief   Ctor. An empty range.
+     */
+    OffsetRange() = default;
+
+    /**
+     * @brief   Ctor.
+     * @param   url         the URL string.
+     * @param   begin       the first offset pair (start and length in url).
+     * @param   end         past the last offset pair.
+     */
+    OffsetRange(char const * url,
+                std::pair<std::size_t, std::size_t> const * begin,
+                std::pair<std::size_t, std::size_t> const * end)
+        : url_{url}, begin_{begin}, end_{end} {
+    }
+
+    /**
+     * @brief   Returns an item.
+     * @param   n       the index of the item (must be less than size()).
+     * @return  The n-th item.
+     */
+    [[nodiscard]] std::string_view operator[](std::size_t n) const {
+        return std::string_view{url_ + begin_[n].first, begin_[n].second};
+    }
+
+    /**
+     * @brief   Returns the last item (the range must not be empty).
+     * @return  The last item.
+     */
+    [[nodiscard]] std::string_view back() const {
+        return (*this)[size() - 1];
+    }
+
+    /**
+     * @brief   Returns an iterator to the first item.
+     * @return  Iterator to the first item.
+     */
+    [[nodiscard]] Iterator begin() const {
+        return Iterator{url_, begin_};
+    }
+
+    /**
+     * @brief   Checks if the range is empty.
+     * @return  true, if there are no items.
+     */
+    [[nodiscard]] bool empty() const {
+        return begin_ == end_;
+    }
+
+    /**
+     * @brief   Returns an iterator past the last item.
+     * @return  Iterator past the last item.
+     */
+    [[nodiscard]] Iterator end() const {
+        return Iterator{url_, end_};
+    }
+
+    /**
+     * @brief   Returns the first item (the range must not be empty).
+     * @return  The first item.
+     */
+    [[nodiscard]] std::string_view front() const {
+        return (*this)[0];
+    }
+
+    /**
+     * @brief   Returns a reverse iterator to the last item.
+     * @return  Reverse iterator to the last item.
+     */
+    [[nodiscard]] reverse_iterator rbegin() const {
+        return reverse_iterator{end()};
+    }
+
+    /**
+     * @brief   Returns a reverse iterator before the first item.
+     * @return  Reverse iterator before the first item.
+     */
+    [[nodiscard]] reverse_iterator rend() const {
+        return reverse_iterator{begin()};
+    }
+
+    /**
+     * @brief   Returns the number of items.
+     * @return  The number of items.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return static_cast<std::size_t>(end_ - begin_);
+    }
+};
+
+
+/**
+ * @brief   Tag selecting the trusted parse mode.
+ *
+ * Trusted input (e.g. URLs created by our own code) is known to be valid:
+ * the parser then only locates the delimiters of the components and skips
+ * the per character grammar checks of userinfo, host, path, query and
+ * fragment. Debug builds (DEBUG defined) still assert the input passes the full validation.
+ */
+struct TrustedInput {};
+
+
+/**
+ * @brief   The trusted parse mode tag.
+ */
+constexpr TrustedInput kTrustedInput{};
+
+
+/**
+ * @brief   The default parse policy: the full RFC 3986 grammar with all components stored.
+ *
+ * A policy is a struct with static constexpr bool flags. To drop parse work derive
+ * from this policy and disable flags, e.g.
+ * @code
+ *      struct RouterPolicy : headcode::url::DefaultURLPolicy {
+ *          static constexpr bool kStoreFragment = false;
+ *          static constexpr bool kValidateUserInfo = false;
+ *      };
+ *      using RouterURL = headcode::url::BasicURL<RouterPolicy>;
+ * @endcode
+ */
+struct DefaultURLPolicy {
+    static constexpr bool kSplitSegments = true;           //!< @brief Split the path (GetSegments(), GetPathPart()).
+    static constexpr bool kSplitQuery = true;              //!< @brief Split the query (GetQueryItems()).
+    static constexpr bool kValidateUserInfo = true;        //!< @brief Validate the characters of the userinfo.
+    static constexpr bool kStoreFragment = true;           //!< @brief Parse the fragment (else it is ignored).
+};
+
+
+/**
+ * @brief namespace for inner implementation details.
+ */
+namespace impl {
+
+
+/**
+ * @brief   The components following the scheme, in the order of the URL.
+ */
+enum class URLComponent {
+    kAuthority = 0,        //!< @brief The authority (userinfo, host and port).
+    kPath,                 //!< @brief The path (and its segments).
+    kQuery,                //!< @brief The query (and its items).
+    kFragment              //!< @brief The fragment.
+};
+
+
+/**
+ * @brief   Start and length of the items of a component (e.g. path segments).
+ */
+using Offsets = std::vector<std::pair<std::size_t, std::size_t>, URLAllocator<std::pair<std::size_t, std::size_t>>>;
+
+
+/**
+ * @brief   Counts the items of a component instead of storing them (used if a split is disabled).
+ */
+struct OffsetCounter {
+
+    std::size_t count_{0};        //!< @brief The number of items.
+
+    /**
+     * @brief   Forgets all items.
+     */
+    void clear() {
+        count_ = 0;
+    }
+
+    /**
+     * @brief   Checks if there are no items.
+     * @return  true, if no item has been counted.
+     */
+    [[nodiscard]] bool empty() const {
+        return count_ == 0;
+    }
+
+    /**
+     * @brief   Returns the number of items.
+     * @return  The number of items counted.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count_;
+    }
+
+    /**
+     * @brief   Counts an item.
+     */
+    void emplace_back(std::size_t, std::size_t) {
+        ++count_;
+    }
+};
+
+
+/**
+ * @brief   The storage of the path segments (empty if not split).
+ */
+template <bool Enabled>
+struct SegmentStorage {
+    Offsets segments_;        //!< @brief The parsed segments of the path in the URL.
+};
+
+template <>
+struct SegmentStorage<false> {};
+
+
+/**
+ * @brief   The storage of the query items (empty if not split).
+ */
+template <bool Enabled>
+struct QueryItemStorage {
+    Offsets query_items_;        //!< @brief The parsed query items of the query in the URL.
 };
 
+template <>
+struct QueryItemStorage<false> {};
+
 
 /**
- * @brief   The URL class.
+ * @brief   The storage of the fragment (empty if not stored).
+ */
+template <bool Enabled>
+struct FragmentStorage {
+    std::pair<std::size_t, std::size_t> fragment_;        //!< @brief The parsed fragment of the URL.
+    bool fragment_present_{false};        //!< @brief Flag stating that a fragment is present (though maybe empty)
+};
+
+template <>
+struct FragmentStorage<false> {};
+
+
+}
+
+
+/**
+ * @brief   Removes the dot segments of a path in place (RFC 3986 5.2.4 remove_dot_segments).
+ *
+ * The output is written forward into the very same buffer: it never gets
+ * ahead of the input. Neither allocates nor needs any temporary.
+ *
+ * Example:
+ * @code
+ *      char path[] = "/a/b/c/./../../g";
+ *      auto size = headcode::url::RemoveDotSegments(path, sizeof(path) - 1);
+ *      std::cout << std::string_view{path, size} << std::endl;          // <-- yields "/a/g"
+ * @endcode
+ *
+ * @param   path        the path to modify.
+ * @param   size        the size of the path.
+ * @return  The size of the path without dot segments.
+ */
+std::size_t RemoveDotSegments(char * path, std::size_t size);
+
+
+/**
+ * @brief   Removes the dot segments of a path in place (RFC 3986 5.2.4 remove_dot_segments).
+ * @param   path        the path to modify (shrinks, never reallocates).
+ */
+void RemoveDotSegments(std::string & path);
+
+
+/**
+ * @brief   The URL class template.
  *
  * Taken from RFC 3986:
  * The following are two example URIs and their component parts:
@@ -74,6 +579,12 @@ enum class ParseError {
  *
  *      GetQueryItems()         ... all identified query sub-items with the '&' delimiter.
  *
+ *      Segments(), QueryItems()        ... the segments and query items as view without allocation.
+ *
+ * The Policy selects the parse work done (see DefaultURLPolicy). Disabled
+ * stages are not compiled in, nor is their storage in the object; their
+ * accessors fail to compile. URL is the BasicURL of the DefaultURLPolicy.
+ *
  * Also the url itself is not copied around but the accessor functions
  * return std::string_view objects, meaning very little to nearly no overhead.
  * However objects of this class must still exist, if you access the the data.
@@ -101,7 +612,10 @@ enum class ParseError {
  *      }
  * @endcode
  */
-class URL {
+template <typename Policy = DefaultURLPolicy>
+class BasicURL : private impl::SegmentStorage<Policy::kSplitSegments>,
+                 private impl::QueryItemStorage<Policy::kSplitQuery>,
+                 private impl::FragmentStorage<Policy::kStoreFragment> {
 
     std::string url_;        //!< @brief The input URL given to be parsed.
 
@@ -109,55 +623,87 @@ class URL {
 
     std::pair<std::size_t, std::size_t> authority_;        //!< @brief The parsed authority of the URL.
     std::pair<std::size_t, std::size_t> host_;             //!< @brief The parsed host of the URL.
+    HostAddress host_address_;                             //!< @brief The binary host of the URL.
     std::pair<std::size_t, std::size_t> path_;             //!< @brief The parsed path of the URL.
-    std::vector<std::pair<std::size_t, std::size_t>>
-            segments_;                                    //!< @brief The parsed segments of the path in the URL.
-    std::pair<std::size_t, std::size_t> port_;            //!< @brief The parsed port of the URL.
-    std::pair<std::size_t, std::size_t> scheme_;          //!< @brief The parsed scheme of the URL.
-    std::pair<std::size_t, std::size_t> userinfo_;        //!< @brief The parsed userinfo of the URL.
-    std::pair<std::size_t, std::size_t> query_;           //!< @brief The parsed query of the URL.
-    std::vector<std::pair<std::size_t, std::size_t>>
-            query_items_;                                 //!< @brief The parsed query items of the query in the URL.
-    std::pair<std::size_t, std::size_t> fragment_;        //!< @brief The parsed fragment of the URL.
+    std::pair<std::size_t, std::size_t> port_;             //!< @brief The parsed port of the URL.
+    std::uint16_t port_number_{0};                         //!< @brief The numeric value of the parsed port.
+    std::pair<std::size_t, std::size_t> scheme_;           //!< @brief The parsed scheme of the URL.
+    SchemeKind scheme_kind_{SchemeKind::kUnknown};         //!< @brief The well known scheme identified.
+    std::pair<std::size_t, std::size_t> userinfo_;         //!< @brief The parsed userinfo of the URL.
+    std::pair<std::size_t, std::size_t> query_;            //!< @brief The parsed query of the URL.
 
-    bool query_present_{false};           //!< @brief Flag stating that a query is present (though maybe empty)
-    bool fragment_present_{false};        //!< @brief Flag stating that a fragment is present (though maybe empty)
+    bool query_present_{false};        //!< @brief Flag stating that a query is present (though maybe empty)
 
 public:
     /**
      * @brief   Ctor.
      * @param   url         the url to parse.
      */
-    explicit URL(std::string url = std::string{}) : url_{std::move(url)} {
+    explicit BasicURL(std::string url = std::string{}) : url_{std::move(url)} {
         Parse();
     }
 
+    /**
+     * @brief   Ctor.
+     * @param   url         the url to parse.
+     * @param   limits      the limits to apply while parsing.
+     */
+    BasicURL(std::string url, ParseLimits const & limits) : url_{std::move(url)} {
+        Parse(limits);
+    }
+
+    /**
+     * @brief   Ctor for trusted (known to be valid) input: locates the components without validation.
+     * @param   url         the url to parse.
+     */
+    BasicURL(std::string url, TrustedInput) : url_{std::move(url)} {
+        Parse<false>();
+    }
+
     /**
      * @brief   Copy Ctor.
      */
-    URL(URL const &) = default;
+    BasicURL(BasicURL const &) = default;
 
     /**
      * @brief   Move Ctor.
      */
-    URL(URL &&) noexcept = default;
+    BasicURL(BasicURL &&) noexcept = default;
 
     /**
      * @brief   Dtor.
      */
-    ~URL() = default;
+    ~BasicURL() = default;
 
     /**
      * @brief   Copy assigment.
      * @return  (*this)
      */
-    URL & operator=(URL const &) = default;
+    BasicURL & operator=(BasicURL const &) = default;
 
     /**
      * @brief   Move assigment.
      * @return  (*this)
      */
-    URL & operator=(URL &&) noexcept = default;
+    BasicURL & operator=(BasicURL &&) noexcept = default;
+
+    /**
+     * @brief   Parses a new URL reusing this object.
+     *
+     * The memory held for the URL string, the path segments and the query
+     * items is kept, so a URL object reused for many URLs stops allocating
+     * once its buffers have grown large enough.
+     *
+     * @param   url         the url to parse.
+     * @param   limits      the limits to apply while parsing.
+     */
+    void Assign(std::string_view url, ParseLimits const & limits = ParseLimits{});
+
+    /**
+     * @brief   Parses a new trusted (known to be valid) URL reusing this object.
+     * @param   url         the url to parse.
+     */
+    void Assign(std::string_view url, TrustedInput);
 
     /**
      * @brief   Returns the parsed authority.
@@ -167,6 +713,12 @@ public:
         return std::string_view{url_}.substr(authority_.first, authority_.second);
     }
 
+    /**
+     * @brief   Returns the port to connect to.
+     * @return  The parsed port number or the default port of the scheme if no port is given (0 if unknown).
+     */
+    [[nodiscard]] std::uint16_t GetEffectivePort() const;
+
     /**
      * @brief   The error after parsing.
      * @return  The error value encountered.
@@ -180,7 +732,8 @@ public:
      * @return  The fragment parsed.
      */
     [[nodiscard]] std::string_view GetFragment() const {
-        return std::string_view{url_}.substr(fragment_.first, fragment_.second);
+        static_assert(Policy::kStoreFragment, "The fragment is not stored with this policy.");
+        return std::string_view{url_}.substr(this->fragment_.first, this->fragment_.second);
     }
 
     /**
@@ -191,6 +744,38 @@ public:
         return std::string_view{url_}.substr(host_.first, host_.second);
     }
 
+    /**
+     * @brief   Returns the parsed host in binary form.
+     * @return  The type and the address of the host parsed.
+     */
+    [[nodiscard]] HostAddress const & GetHostAddress() const {
+        return host_address_;
+    }
+
+    /**
+     * @brief   Returns the type of the parsed host.
+     * @return  The kind of host parsed.
+     */
+    [[nodiscard]] HostType GetHostType() const {
+        return host_address_.type_;
+    }
+
+    /**
+     * @brief   Returns the IPv4 address of the host.
+     * @return  The IPv4 address in host byte order (0 if the host is not an IPv4 address).
+     */
+    [[nodiscard]] std::uint32_t GetIPv4() const {
+        return host_address_.ipv4_;
+    }
+
+    /**
+     * @brief   Returns the IPv6 address of the host.
+     * @return  The 16 bytes of the IPv6 address in network byte order (all 0 if the host is not an IPv6 address).
+     */
+    [[nodiscard]] std::array<std::uint8_t, 16> const & GetIPv6() const {
+        return host_address_.ipv6_;
+    }
+
     /**
      * @brief   Returns the parsed path.
      * @return  The path parsed.
@@ -206,11 +791,13 @@ public:
      */
     [[nodiscard]] std::string_view GetPathPart(std::size_t n) const {
 
-        if (segments_.empty()) {
+        static_assert(Policy::kSplitSegments, "The path is not split with this policy.");
+        auto const & segments = this->segments_;
+        if (segments.empty()) {
             return std::string_view{};
         }
-        n = std::min(n, segments_.size() - 1);
-        auto total_length = segments_[n].first - path_.first + segments_[n].second;
+        n = std::min(n, segments.size() - 1);
+        auto total_length = segments[n].first - path_.first + segments[n].second;
         return std::string_view{url_}.substr(path_.first, total_length);
     }
 
@@ -222,6 +809,14 @@ public:
         return std::string_view{url_}.substr(port_.first, port_.second);
     }
 
+    /**
+     * @brief   Returns the parsed port as number.
+     * @return  The port number parsed (0 if no port is given).
+     */
+    [[nodiscard]] std::uint16_t GetPortNumber() const {
+        return port_number_;
+    }
+
     /**
      * @brief   Returns the parsed query.
      * @return  The query parsed.
@@ -235,11 +830,8 @@ public:
      * @return  The query items parsed.
      */
     [[nodiscard]] std::vector<std::string_view> GetQueryItems() const {
-        std::vector<std::string_view> query_items;
-        for (auto const & p : query_items_) {
-            query_items.emplace_back(std::string_view{url_}.substr(p.first, p.second));
-        }
-        return query_items;
+        auto query_items = QueryItems();
+        return std::vector<std::string_view>{query_items.begin(), query_items.end()};
     }
 
     /**
@@ -250,16 +842,21 @@ public:
         return std::string_view{url_}.substr(scheme_.first, scheme_.second);
     }
 
+    /**
+     * @brief   Returns the well known scheme identified.
+     * @return  The kind of scheme (case-insensitive) or SchemeKind::kUnknown.
+     */
+    [[nodiscard]] SchemeKind GetSchemeKind() const {
+        return scheme_kind_;
+    }
+
     /**
      * @brief   Returns the segments of the path as vector.
      * @return  The parsed segments of the path.
      */
     [[nodiscard]] std::vector<std::string_view> GetSegments() const {
-        std::vector<std::string_view> segments;
-        for (auto const & p : segments_) {
-            segments.emplace_back(std::string_view{url_}.substr(p.first, p.second));
-        }
-        return segments;
+        auto segments = Segments();
+        return std::vector<std::string_view>{segments.begin(), segments.end()};
     }
 
     /**
@@ -283,9 +880,17 @@ public:
      * @return  True, if there is a '#'.
      */
     [[nodiscard]] bool IsFragmentPresent() const {
-        return fragment_present_;
+        static_assert(Policy::kStoreFragment, "The fragment is not stored with this policy.");
+        return this->fragment_present_;
     }
 
+    /**
+     * @brief   Checks if the host equals the given host ignoring case (ASCII only, no decoding).
+     * @param   host        the host to compare with.
+     * @return  true, if the host of this URL is host.
+     */
+    [[nodiscard]] bool IsHost(std::string_view host) const;
+
     /**
      * @brief   Checks if the path is absolute.
      * @return  true, if the path is absolute.
@@ -302,6 +907,13 @@ public:
         return query_present_;
     }
 
+    /**
+     * @brief   Checks if the scheme equals the given scheme ignoring case.
+     * @param   scheme      the scheme to compare with.
+     * @return  true, if the scheme of this URL is scheme.
+     */
+    [[nodiscard]] bool IsScheme(std::string_view scheme) const;
+
     /**
      * @brief   Checks if this is a valid URL object.
      * @return  true, if we have successfully parsed the given URL.
@@ -312,18 +924,187 @@ public:
 
     /**
      * @brief   Returns a normalized version of the given URL.
+     *
+     * Scheme and host are lower case, dot segments are removed and percent
+     * encodings are normalized in all components (RFC 3986 6.2.2): unreserved
+     * characters are decoded, all others get upper case hex digits.
+     *
      * @return  A new URL object with the very same url, but normalized.
      */
-    [[nodiscard]] URL Normalize() const;
+    [[nodiscard]] BasicURL Normalize() const;
+
+    /**
+     * @brief   Returns the parsed query items as view (no allocation).
+     * @return  The query items parsed, valid until this object is modified.
+     */
+    [[nodiscard]] OffsetRange QueryItems() const {
+        static_assert(Policy::kSplitQuery, "The query is not split with this policy.");
+        auto const & query_items = this->query_items_;
+        return OffsetRange{url_.data(), query_items.data(), query_items.data() + query_items.size()};
+    }
+
+    /**
+     * @brief   Returns the segments of the path as view (no allocation).
+     * @return  The parsed segments of the path, valid until this object is modified.
+     */
+    [[nodiscard]] OffsetRange Segments() const {
+        static_assert(Policy::kSplitSegments, "The path is not split with this policy.");
+        auto const & segments = this->segments_;
+        return OffsetRange{url_.data(), segments.data(), segments.data() + segments.size()};
+    }
+
+    // Mutators: each validates the new value only, splices it into the URL
+    // string and shifts the offsets of the following components. No reparse.
+    // On an invalid URL or an invalid value they return false and leave the URL as is.
+
+    /**
+     * @brief   Appends an item to the query ('&' separated), adding the query if missing.
+     * @param   item        the new query item (not empty, no '&').
+     * @return  true, if the item has been appended.
+     */
+    bool AppendQueryItem(std::string_view item);
+
+    /**
+     * @brief   Appends a segment to the path ('/' separated).
+     * @param   segment     the new path segment (not empty, no '/').
+     * @return  true, if the segment has been appended.
+     */
+    bool AppendSegment(std::string_view segment);
+
+    /**
+     * @brief   Removes the fragment including the '#'.
+     * @return  true, if the URL is valid.
+     */
+    bool RemoveFragment();
+
+    /**
+     * @brief   Removes the port including the ':'.
+     * @return  true, if the URL is valid and has an authority.
+     */
+    bool RemovePort();
+
+    /**
+     * @brief   Removes the query including the '?'.
+     * @return  true, if the URL is valid.
+     */
+    bool RemoveQuery();
+
+    /**
+     * @brief   Removes the query items matching a predicate in a single pass in place.
+     * A removed item takes its '&' along, trailing empty items are dropped and the
+     * query including the '?' is removed if no item is left.
+     * @param   predicate       called with each query item, returns true to remove it.
+     * @return  The number of items removed.
+     */
+    template <typename Predicate>
+    std::size_t RemoveQueryItems(Predicate && predicate);
+
+    /**
+     * @brief   Sets the fragment, adding a '#' if missing.
+     * @param   fragment    the new fragment.
+     * @return  true, if the fragment has been set.
+     */
+    bool SetFragment(std::string_view fragment);
+
+    /**
+     * @brief   Sets the host, adding an authority ("//") if missing.
+     * @param   host        the new host (IP literals enclosed in '[' and ']').
+     * @return  true, if the host has been set.
+     */
+    bool SetHost(std::string_view host);
+
+    /**
+     * @brief   Sets the path.
+     * @param   path        the new path (absolute or empty if the URL has an authority).
+     * @return  true, if the path has been set.
+     */
+    bool SetPath(std::string_view path);
+
+    /**
+     * @brief   Sets the port.
+     * @param   port_number     the new port.
+     * @return  true, if the URL is valid and has an authority.
+     */
+    bool SetPort(std::uint16_t port_number);
+
+    /**
+     * @brief   Sets the query, adding a '?' if missing.
+     * @param   query       the new query.
+     * @return  true, if the query has been set.
+     */
+    bool SetQuery(std::string_view query);
+
+    /**
+     * @brief   Sets the scheme.
+     * @param   scheme      the new scheme.
+     * @return  true, if the scheme has been set.
+     */
+    bool SetScheme(std::string_view scheme);
 
 private:
+    /**
+     * @brief   Places the empty components not reached by the parser at the end of the URL.
+     * Absent query and fragment are placed at their position of insertion.
+     * @param   from        the first component not reached.
+     */
+    void AnchorEmptyComponents(impl::URLComponent from);
+
+    /**
+     * @brief   Checks if the URL has an authority (i.e. "//" after the scheme), though maybe empty.
+     * @return  true, if there is an authority.
+     */
+    [[nodiscard]] bool HasAuthority() const;
+
+    /**
+     * @brief   Start of the host in the URL string including the '[' of IP literals.
+     * @return  The start index of the host.
+     */
+    [[nodiscard]] std::size_t HostBegin() const;
+
+    /**
+     * @brief   End of the host in the URL string including the ']' of IP literals.
+     * @return  The end index of the host.
+     */
+    [[nodiscard]] std::size_t HostEnd() const;
+
     /**
      * @brief   Parses the given url.
+     * @param   limits      the limits to apply while parsing.
+     * @tparam  Validate    check the characters of the components (else only locate them).
+     */
+    template <bool Validate = true>
+    void Parse(ParseLimits const & limits = ParseLimits{});
+
+    /**
+     * @brief   Replaces a part of the URL string.
+     * @param   pos         start of the part to replace.
+     * @param   length      length of the part to replace.
+     * @param   value       the new value.
+     * @return  The change in size of the URL string.
      */
-    void Parse();
+    std::ptrdiff_t Replace(std::size_t pos, std::size_t length, std::string_view value);
+
+    /**
+     * @brief   Resets all parsed components but keeps the allocated memory.
+     */
+    void Reset();
+
+    /**
+     * @brief   Shifts the offsets of a component and all components following it.
+     * Components absent (query, fragment) are placed at their position of insertion.
+     * @param   from        the first component to shift.
+     * @param   delta       the number of characters to shift.
+     */
+    void ShiftComponents(impl::URLComponent from, std::ptrdiff_t delta);
 };
 
 
+/**
+ * @brief   The URL with the full RFC 3986 grammar.
+ */
+using URL = BasicURL<DefaultURLPolicy>;
+
+
 }
 
 
@@ -0,0 +1,390 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_RECORD_HPP
+#define HEADCODE_SPACE_URL_URL_RECORD_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A single parsed URL stored in the binary record format.
+ *
+ * Objects of this class are very lightweight views on a record inside a
+ * buffer (e.g. a memory mapped file) as written by the URLRecordWriter.
+ * All values are read directly from the buffer: there is no parsing and
+ * no copying involved. The buffer must outlive the record.
+ *
+ * The record format (all integers are little endian, records are 4 byte aligned):
+ *
+ *      offset  size    field
+ *      0       4       total size of the record in bytes (including padding)
+ *      4       4       size of the URL string
+ *      8       1       ParseError
+ *      9       1       flags (0x01: query present, 0x02: fragment present)
+ *      10      1       SchemeKind
+ *      11      1       HostType
+ *      12      2       port number
+ *      14      2       reserved (0)
+ *      16      4       IPv4 address
+ *      20      16      IPv6 address
+ *      36      64      start and length of authority, fragment, host, path, port, query, scheme, userinfo
+ *      100     4       number of path segments (S)
+ *      104     4       number of query items (Q)
+ *      108     S * 8   start and length of each path segment
+ *      ...     Q * 8   start and length of each query item
+ *      ...     ...     the URL string, zero padded to a multiple of 4
+ */
+class URLRecord {
+
+    char const * data_{nullptr};        //!< @brief Start of the record.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   data        start of a record (already checked by the URLRecordReader).
+     */
+    explicit URLRecord(char const * data = nullptr) : data_{data} {
+    }
+
+    /**
+     * @brief   Returns the authority.
+     * @return  The authority parsed.
+     */
+    [[nodiscard]] std::string_view GetAuthority() const;
+
+    /**
+     * @brief   The error after parsing.
+     * @return  The error value encountered.
+     */
+    [[nodiscard]] ParseError GetError() const;
+
+    /**
+     * @brief   Returns the fragment.
+     * @return  The fragment parsed.
+     */
+    [[nodiscard]] std::string_view GetFragment() const;
+
+    /**
+     * @brief   Returns the host.
+     * @return  The host parsed.
+     */
+    [[nodiscard]] std::string_view GetHost() const;
+
+    /**
+     * @brief   Returns the type of the host.
+     * @return  The kind of host parsed.
+     */
+    [[nodiscard]] HostType GetHostType() const;
+
+    /**
+     * @brief   Returns the IPv4 address of the host.
+     * @return  The IPv4 address in host byte order (0 if the host is not an IPv4 address).
+     */
+    [[nodiscard]] std::uint32_t GetIPv4() const;
+
+    /**
+     * @brief   Returns the IPv6 address of the host.
+     * @return  The 16 bytes of the IPv6 address in network byte order.
+     */
+    [[nodiscard]] std::array<std::uint8_t, 16> GetIPv6() const;
+
+    /**
+     * @brief   Returns the path.
+     * @return  The path parsed.
+     */
+    [[nodiscard]] std::string_view GetPath() const;
+
+    /**
+     * @brief   Returns the port.
+     * @return  The port parsed.
+     */
+    [[nodiscard]] std::string_view GetPort() const;
+
+    /**
+     * @brief   Returns the port as number.
+     * @return  The port number parsed (0 if no port is given).
+     */
+    [[nodiscard]] std::uint16_t GetPortNumber() const;
+
+    /**
+     * @brief   Returns the query.
+     * @return  The query parsed.
+     */
+    [[nodiscard]] std::string_view GetQuery() const;
+
+    /**
+     * @brief   Returns a single query item.
+     * @param   n       the index of the query item.
+     * @return  The n-th query item (empty if out of range).
+     */
+    [[nodiscard]] std::string_view GetQueryItem(std::size_t n) const;
+
+    /**
+     * @brief   Returns the number of query items.
+     * @return  The number of query items.
+     */
+    [[nodiscard]] std::size_t GetQueryItemCount() const;
+
+    /**
+     * @brief   Returns the scheme.
+     * @return  The scheme parsed.
+     */
+    [[nodiscard]] std::string_view GetScheme() const;
+
+    /**
+     * @brief   Returns the well known scheme.
+     * @return  The kind of scheme.
+     */
+    [[nodiscard]] SchemeKind GetSchemeKind() const;
+
+    /**
+     * @brief   Returns a single path segment.
+     * @param   n       the index of the segment.
+     * @return  The n-th segment (empty if out of range).
+     */
+    [[nodiscard]] std::string_view GetSegment(std::size_t n) const;
+
+    /**
+     * @brief   Returns the number of path segments.
+     * @return  The number of path segments.
+     */
+    [[nodiscard]] std::size_t GetSegmentCount() const;
+
+    /**
+     * @brief   Returns the total size of this record in the buffer.
+     * @return  The size of the record in bytes.
+     */
+    [[nodiscard]] std::size_t GetSize() const;
+
+    /**
+     * @brief   Returns the URL string.
+     * @return  The URL string stored in the record.
+     */
+    [[nodiscard]] std::string_view GetURL() const;
+
+    /**
+     * @brief   Returns the userinfo.
+     * @return  The userinfo parsed.
+     */
+    [[nodiscard]] std::string_view GetUserInfo() const;
+
+    /**
+     * @brief   States if the url has a fragment (at least '#' char; also if the fragment is empty)
+     * @return  True, if there is a '#'.
+     */
+    [[nodiscard]] bool IsFragmentPresent() const;
+
+    /**
+     * @brief   States if the url has a query (at least '?' char; also if the query is empty)
+     * @return  True, if there is a '?'.
+     */
+    [[nodiscard]] bool IsQueryPresent() const;
+
+    /**
+     * @brief   Checks if the URL has been parsed successfully.
+     * @return  true, if the URL is valid.
+     */
+    [[nodiscard]] bool IsValid() const {
+        return GetError() == ParseError::kNoError;
+    }
+
+    /**
+     * @brief   Creates a full URL object from the record (this parses again).
+     * @return  An URL object.
+     */
+    [[nodiscard]] URL ToURL() const {
+        return URL{std::string{GetURL()}};
+    }
+
+private:
+    /**
+     * @brief   Returns a sub string of the URL string stored.
+     * @param   offset      offset of the start and length pair in the record.
+     * @return  The sub string (empty if the pair is out of bounds).
+     */
+    [[nodiscard]] std::string_view GetSlice(std::size_t offset) const;
+};
+
+
+/**
+ * @brief   Reads URL records from a buffer, e.g. a memory mapped file.
+ *
+ * The buffer holds a file header followed by the records as written by
+ * the URLRecordWriter. Iterating over the reader yields URLRecord objects
+ * pointing directly into the buffer.
+ *
+ * Example:
+ * @code
+ *      // data points to the mmap'ed file content
+ *      headcode::url::URLRecordReader reader{std::string_view{data, size}};
+ *      for (auto const & record : reader) {
+ *          std::cout << record.GetHost() << std::endl;
+ *      }
+ * @endcode
+ *
+ * Records are checked to lie completely inside the buffer. Iteration stops
+ * at the first damaged record.
+ */
+class URLRecordReader {
+
+    std::string_view data_;        //!< @brief The data to read from.
+
+public:
+    /**
+     * @brief   Forward iterator over the records.
+     */
+    class Iterator {
+
+        std::string_view data_;        //!< @brief The data to read from.
+        std::size_t pos_{0};           //!< @brief Position of the current record in data_.
+
+    public:
+        using iterator_category = std::forward_iterator_tag;        //!< @brief Iterator category.
+        using value_type = URLRecord;                               //!< @brief Value type.
+        using difference_type = std::ptrdiff_t;                     //!< @brief Difference type.
+        using pointer = URLRecord const *;                          //!< @brief Pointer type.
+        using reference = URLRecord;                                //!< @brief Reference type.
+
+        /**
+         * @brief   Ctor.
+         * @param   data        the data to read from.
+         * @param   pos         the position of the record (data.size() for end).
+         */
+        Iterator(std::string_view data, std::size_t pos);
+
+        /**
+         * @brief   Dereference.
+         * @return  The current record.
+         */
+        URLRecord operator*() const {
+            return URLRecord{data_.data() + pos_};
+        }
+
+        /**
+         * @brief   Advance to the next record.
+         * @return  (*this)
+         */
+        Iterator & operator++();
+
+        /**
+         * @brief   Equality.
+         * @param   rhs         the other iterator.
+         * @return  true, if both point to the same record.
+         */
+        bool operator==(Iterator const & rhs) const {
+            return (data_.data() == rhs.data_.data()) && (pos_ == rhs.pos_);
+        }
+
+        /**
+         * @brief   Inequality.
+         * @param   rhs         the other iterator.
+         * @return  true, if both point to different records.
+         */
+        bool operator!=(Iterator const & rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        /**
+         * @brief   Checks the record at pos_ and moves to the end if it is damaged.
+         */
+        void Check();
+    };
+
+    /**
+     * @brief   Ctor.
+     * @param   data        the data (file header and records) to read.
+     */
+    explicit URLRecordReader(std::string_view data);
+
+    /**
+     * @brief   Start of the records.
+     * @return  Iterator to the first record.
+     */
+    [[nodiscard]] Iterator begin() const;
+
+    /**
+     * @brief   End of the records.
+     * @return  Iterator past the last record.
+     */
+    [[nodiscard]] Iterator end() const;
+
+    /**
+     * @brief   Checks if the file header is valid.
+     * @return  true, if the data starts with a valid file header.
+     */
+    [[nodiscard]] bool IsValid() const {
+        return !data_.empty();
+    }
+};
+
+
+/**
+ * @brief   Writes parsed URLs in the binary record format to a stream.
+ *
+ * The stream receives a file header on construction and one record per
+ * call to Write(). The result can be read with an URLRecordReader.
+ *
+ * Example:
+ * @code
+ *      std::ofstream out{"frontier.bin", std::ios::binary};
+ *      headcode::url::URLRecordWriter writer{out};
+ *      for (auto const & url : urls) {
+ *          writer.Write(url);
+ *      }
+ * @endcode
+ */
+class URLRecordWriter {
+
+    std::ostream & out_;              //!< @brief The stream to write to.
+    std::string buffer_;              //!< @brief Buffer for a single record.
+    std::size_t count_{0};            //!< @brief Number of records written.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   out         the stream to write to (a file header is written immediately).
+     */
+    explicit URLRecordWriter(std::ostream & out);
+
+    /**
+     * @brief   Returns the number of records written so far.
+     * @return  The number of records written.
+     */
+    [[nodiscard]] std::size_t GetCount() const {
+        return count_;
+    }
+
+    /**
+     * @brief   Writes a single URL.
+     * @param   url         the URL to write.
+     */
+    void Write(URL const & url);
+};
+
+
+}
+
+
+#include "headcode/url/impl/url_record_impl.hpp"
+
+
+#endif
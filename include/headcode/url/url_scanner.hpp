@@ -0,0 +1,94 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_SCANNER_HPP
+#define HEADCODE_SPACE_URL_URL_SCANNER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   Finds URLs in arbitrary text like HTML bodies, log lines or mails.
+ *
+ * A candidate is anchored at a "://": the scheme is taken from the scheme
+ * characters right before it and the URL is extended to the maximal run of
+ * characters valid in an URL (RFC 3986: unreserved, reserved and percent
+ * encodings). Trailing punctuation which is rather part of the text (".,;:!?'"
+ * and unbalanced ')' or ']') is cut off. An URL in single quotes ends at the
+ * closing quote.
+ *
+ * The ':' are searched with memchr(), which is vectorized by the C library:
+ * text without any ':' is skipped at memory speed. Each character of the text
+ * is looked at a constant number of times, so scanning is linear.
+ *
+ * The URLs found are views into the scanned text. The text is not copied:
+ * it must outlive the scanner and the views.
+ *
+ * Example:
+ * @code
+ *      headcode::url::URLScanner scanner{"see <a href=\"https://example.com/a?b=c\">here</a> (or ftp://host/)."};
+ *      std::string_view found;
+ *      while (scanner.Next(found)) {
+ *          std::cout << found << std::endl;       // <-- yields "https://example.com/a?b=c", "ftp://host/"
+ *      }
+ * @endcode
+ */
+class URLScanner {
+
+    std::string_view text_;            //!< @brief The text to scan.
+    std::size_t position_{0};          //!< @brief The position to continue scanning at.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   text        the text to scan (not copied).
+     */
+    explicit URLScanner(std::string_view text) : text_{text} {
+    }
+
+    /**
+     * @brief   Returns the position scanning continues at.
+     * @return  The index in the text right after the last URL found (or the text size at the end).
+     */
+    [[nodiscard]] std::size_t GetPosition() const {
+        return position_;
+    }
+
+    /**
+     * @brief   Finds the next URL candidate.
+     * @param   url         receives the candidate (a view into the text).
+     * @return  true, if a candidate has been found; false at the end of the text.
+     */
+    bool Next(std::string_view & url);
+
+    /**
+     * @brief   Finds and parses the next URL. Candidates which fail to parse are skipped.
+     * @param   url         the URL object to assign (reusing its memory).
+     * @return  true, if a valid URL has been found; false at the end of the text.
+     */
+    template <typename Policy>
+    bool Next(BasicURL<Policy> & url);
+};
+
+
+}
+
+
+#include "headcode/url/impl/url_scanner_impl.hpp"
+
+
+#endif
@@ -0,0 +1,346 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_STREAM_PARSER_HPP
+#define HEADCODE_SPACE_URL_URL_STREAM_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   A resumable parser validating an URL which arrives in chunks (e.g. across socket reads).
+ *
+ * Each chunk is validated right when it is fed: the parser keeps the
+ * state of the URL parser and a small carry-over between the chunks, but
+ * never the URL itself. Path, query and fragment (the large components)
+ * are validated character by character with nothing carried but a pending
+ * percent encoding. Only the scheme (up to the length of the well known
+ * schemes) and the authority are carried until they are complete, since the
+ * userinfo, the host and the port are told apart by their last delimiters.
+ *
+ * The result is the same as parsing the whole URL at once with
+ * BasicURL<Policy>, regardless of where the URL is split. An error is
+ * reported as soon as the chunk holding it is fed; further chunks are
+ * ignored. The components are reported as start and length within the
+ * stream.
+ *
+ * Example:
+ * @code
+ *      headcode::url::URLStreamParser parser;
+ *      while (auto chunk = ReadSome(socket)) {
+ *          if (!parser.Feed(chunk)) {
+ *              return Reject(parser.GetError());           // <-- no need to wait for the rest
+ *          }
+ *      }
+ *      if (parser.Finish()) {
+ *          auto [start, length] = parser.GetHostRange();
+ *          ...
+ *      }
+ * @endcode
+ *
+ * @tparam  Policy      the parse policy of the URL (see DefaultURLPolicy).
+ */
+template <typename Policy = DefaultURLPolicy>
+class BasicURLStreamParser {
+
+    ParseLimits limits_;                                             //!< @brief The limits to enforce.
+    ParseError error_{ParseError::kNoError};                         //!< @brief The first error found.
+    impl::ParserState state_{impl::ParserState::kParsingScheme};     //!< @brief The current stage.
+    std::size_t size_{0};                                            //!< @brief Bytes fed so far.
+    std::size_t offset_{0};                                          //!< @brief Stream position of the chunk fed.
+    std::string carry_;                                              //!< @brief Scheme or authority carried over.
+    std::size_t item_start_{0};                                      //!< @brief Start of the current segment or item.
+    std::uint8_t pending_hex_{0};                                    //!< @brief Hex digits still due after a '%'.
+    bool slash_pending_{false};                                      //!< @brief A '/' right after the scheme.
+
+    std::pair<std::size_t, std::size_t> scheme_{0, 0};               //!< @brief The scheme.
+    SchemeKind scheme_kind_{SchemeKind::kUnknown};                   //!< @brief The well known scheme.
+    std::pair<std::size_t, std::size_t> authority_{0, 0};            //!< @brief The authority.
+    std::pair<std::size_t, std::size_t> userinfo_{0, 0};             //!< @brief The userinfo.
+    std::pair<std::size_t, std::size_t> host_{0, 0};                 //!< @brief The host.
+    HostAddress host_address_;                                       //!< @brief The type and address of the host.
+    std::pair<std::size_t, std::size_t> port_{0, 0};                 //!< @brief The port.
+    std::uint16_t port_number_{0};                                   //!< @brief The numeric value of the port.
+    std::pair<std::size_t, std::size_t> path_{0, 0};                 //!< @brief The path.
+    std::size_t segment_count_{0};                                   //!< @brief The number of path segments.
+    std::pair<std::size_t, std::size_t> query_{0, 0};                //!< @brief The query.
+    std::size_t query_item_count_{0};                                //!< @brief The number of query items.
+    bool query_present_{false};                                      //!< @brief Flag for a '?'.
+    std::pair<std::size_t, std::size_t> fragment_{0, 0};             //!< @brief The fragment.
+    bool fragment_present_{false};                                   //!< @brief Flag for a '#'.
+
+public:
+    /**
+     * @brief   Ctor.
+     * @param   limits      the limits to enforce.
+     */
+    explicit BasicURLStreamParser(ParseLimits const & limits = {}) : limits_{limits} {
+    }
+
+    /**
+     * @brief   Validates the next chunk of the URL.
+     * @param   chunk       the next chunk (not referenced after the call).
+     * @return  true, if the URL is valid so far.
+     */
+    bool Feed(std::string_view chunk);
+
+    /**
+     * @brief   Ends the URL and validates the components still open.
+     * @return  true, if the URL is valid.
+     */
+    bool Finish();
+
+    /**
+     * @brief   Returns the authority.
+     * @return  Start and length of the authority in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetAuthorityRange() const {
+        return authority_;
+    }
+
+    /**
+     * @brief   Returns the parse result.
+     * @return  ParseError::kNoError, if the URL is valid (so far).
+     */
+    [[nodiscard]] ParseError GetError() const {
+        return error_;
+    }
+
+    /**
+     * @brief   Returns the fragment.
+     * @return  Start and length of the fragment in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetFragmentRange() const {
+        return fragment_;
+    }
+
+    /**
+     * @brief   Returns the type and binary address of the host.
+     * @return  The host address.
+     */
+    [[nodiscard]] HostAddress const & GetHostAddress() const {
+        return host_address_;
+    }
+
+    /**
+     * @brief   Returns the host.
+     * @return  Start and length of the host in the stream (IP literals without '[' and ']').
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetHostRange() const {
+        return host_;
+    }
+
+    /**
+     * @brief   Returns the path.
+     * @return  Start and length of the path in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetPathRange() const {
+        return path_;
+    }
+
+    /**
+     * @brief   Returns the port as number.
+     * @return  The port number (0 if none).
+     */
+    [[nodiscard]] std::uint16_t GetPortNumber() const {
+        return port_number_;
+    }
+
+    /**
+     * @brief   Returns the port.
+     * @return  Start and length of the port in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetPortRange() const {
+        return port_;
+    }
+
+    /**
+     * @brief   Returns the number of query items.
+     * @return  The number of query items (like BasicURL::GetQueryItems()).
+     */
+    [[nodiscard]] std::size_t GetQueryItemCount() const {
+        return query_item_count_;
+    }
+
+    /**
+     * @brief   Returns the query.
+     * @return  Start and length of the query (without the '?') in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetQueryRange() const {
+        return query_;
+    }
+
+    /**
+     * @brief   Returns the well known scheme.
+     * @return  The kind of the scheme.
+     */
+    [[nodiscard]] SchemeKind GetSchemeKind() const {
+        return scheme_kind_;
+    }
+
+    /**
+     * @brief   Returns the scheme.
+     * @return  Start and length of the scheme in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetSchemeRange() const {
+        return scheme_;
+    }
+
+    /**
+     * @brief   Returns the number of path segments.
+     * @return  The number of path segments (like BasicURL::GetSegments()).
+     */
+    [[nodiscard]] std::size_t GetSegmentCount() const {
+        return segment_count_;
+    }
+
+    /**
+     * @brief   Returns the number of bytes fed.
+     * @return  The size of the URL so far.
+     */
+    [[nodiscard]] std::size_t GetSize() const {
+        return size_;
+    }
+
+    /**
+     * @brief   Returns the userinfo.
+     * @return  Start and length of the userinfo in the stream.
+     */
+    [[nodiscard]] std::pair<std::size_t, std::size_t> GetUserInfoRange() const {
+        return userinfo_;
+    }
+
+    /**
+     * @brief   States if the URL has a fragment (at least a '#').
+     * @return  true, if there is a '#'.
+     */
+    [[nodiscard]] bool IsFragmentPresent() const {
+        return fragment_present_;
+    }
+
+    /**
+     * @brief   States if the URL has a query (at least a '?').
+     * @return  true, if there is a '?'.
+     */
+    [[nodiscard]] bool IsQueryPresent() const {
+        return query_present_;
+    }
+
+    /**
+     * @brief   Checks if the URL is valid (so far).
+     * @return  true, if no error has been found.
+     */
+    [[nodiscard]] bool IsValid() const {
+        return error_ == ParseError::kNoError;
+    }
+
+    /**
+     * @brief   Starts over with the next URL (reusing the memory of the carry-over).
+     * @param   limits      the limits to enforce.
+     */
+    void Reset(ParseLimits const & limits = {});
+
+private:
+    /**
+     * @brief   Parses the authority carried over once it is complete.
+     */
+    void EndAuthority();
+
+    /**
+     * @brief   Ends the path at a position in the stream.
+     * @param   end         the end of the path.
+     */
+    void EndPath(std::size_t end);
+
+    /**
+     * @brief   Ends the query at a position in the stream.
+     * @param   end         the end of the query.
+     */
+    void EndQuery(std::size_t end);
+
+    /**
+     * @brief   Continues parsing the authority in a chunk.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedAuthority(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Continues parsing the fragment in a chunk.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedFragment(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Decides between authority and path right after the scheme.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedHierPart(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Continues parsing the path in a chunk.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedPath(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Continues parsing the query in a chunk.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedQuery(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Continues parsing the scheme in a chunk.
+     * @param   chunk       the chunk.
+     * @param   i           the position in the chunk.
+     * @return  The position in the chunk to continue at.
+     */
+    std::size_t FeedScheme(std::string_view chunk, std::size_t i);
+
+    /**
+     * @brief   Starts the path at a position in the stream.
+     * @param   start       the start of the path.
+     */
+    void StartPath(std::size_t start);
+};
+
+
+/**
+ * @brief   The stream parser for URLs with the default policy.
+ */
+using URLStreamParser = BasicURLStreamParser<DefaultURLPolicy>;
+
+
+}
+
+
+#include "headcode/url/impl/url_stream_parser_impl.hpp"
+
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_URL_VISITOR_HPP
+#define HEADCODE_SPACE_URL_URL_VISITOR_HPP
+
+#include <cstdint>
+#include <string_view>
+
+#include "url_core.hpp"
+
+
+/**
+ * @brief   The headcode url namespace.
+ */
+namespace headcode::url {
+
+
+/**
+ * @brief   The base of URL visitors: all callbacks do nothing and continue.
+ *
+ * Derive from this struct and hide the callbacks of interest. Each callback
+ * returns true to continue or false to stop the scan. The calls are resolved
+ * at compile time (no virtual functions), so they are inlined.
+ *
+ * The components are passed as views into the scanned URL string.
+ */
+struct URLVisitor {
+
+    /**
+     * @brief   Called with the scheme.
+     * @param   scheme          the scheme.
+     * @param   scheme_kind     the well known scheme.
+     * @return  true, to continue.
+     */
+    bool OnScheme([[maybe_unused]] std::string_view scheme, [[maybe_unused]] SchemeKind scheme_kind) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with the userinfo (only if the authority contains a '@').
+     * @param   userinfo        the userinfo.
+     * @return  true, to continue.
+     */
+    bool OnUserInfo([[maybe_unused]] std::string_view userinfo) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with the host (if there is an authority; the host may be empty).
+     * @param   host            the host (IP literals without '[' and ']').
+     * @param   host_address    the type and binary address of the host.
+     * @return  true, to continue.
+     */
+    bool OnHost([[maybe_unused]] std::string_view host, [[maybe_unused]] HostAddress const & host_address) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with the port (if not empty).
+     * @param   port            the port.
+     * @param   port_number     the numeric value of the port.
+     * @return  true, to continue.
+     */
+    bool OnPort([[maybe_unused]] std::string_view port, [[maybe_unused]] std::uint16_t port_number) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with each path segment.
+     * @param   segment         the path segment.
+     * @return  true, to continue.
+     */
+    bool OnSegment([[maybe_unused]] std::string_view segment) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with each query item (not for an empty query, like BasicURL::GetQueryItems()).
+     * @param   query_item      the query item.
+     * @return  true, to continue.
+     */
+    bool OnQueryItem([[maybe_unused]] std::string_view query_item) {
+        return true;
+    }
+
+    /**
+     * @brief   Called with the fragment (if there is a '#'; the fragment may be empty).
+     * @param   fragment        the fragment.
+     * @return  true, to continue.
+     */
+    bool OnFragment([[maybe_unused]] std::string_view fragment) {
+        return true;
+    }
+};
+
+
+/**
+ * @brief   Scans an URL and passes the components to a visitor, storing none of them.
+ *
+ * This is the streaming counterpart to the URL class: there are no offsets,
+ * no vectors and no allocations, the memory used is constant. The validation
+ * is the very same as for URL. The components are passed as soon as they
+ * have been validated, i.e. on an invalid URL the visitor may have received
+ * the components before the error.
+ *
+ * If a callback returns false the scan stops right after it: e.g. a filter
+ * on the host does not scan path, query and fragment at all. Within the path
+ * and the query the scan then only completes the running stage silently.
+ *
+ * @param   url         the URL to scan.
+ * @param   visitor     the visitor (see URLVisitor).
+ * @param   limits      the limits to apply while scanning.
+ * @return  The error found, ParseError::kNoError if valid or stopped by the visitor before any error.
+ * @tparam  Visitor     the type of the visitor (usually derived from URLVisitor).
+ */
+template <typename Visitor>
+ParseError VisitURL(std::string_view url, Visitor & visitor, ParseLimits const & limits = {});
+
+
+}
+
+
+#include "headcode/url/impl/url_visitor_impl.hpp"
+
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <headcode/url/url.hpp>
+
+#include "harness.hpp"
+
+
+namespace {
+
+
+/**
+ * @brief   A hostile input shape.
+ */
+struct AdversarialShape {
+    std::string name_;                                  //!< @brief Name of the shape.
+    std::string (*make_)(std::size_t size);        //!< @brief Creates an input of about the given size.
+};
+
+
+/**
+ * @brief   Repeats a string.
+ * @param   pattern     the string to repeat.
+ * @param   size        the minimum size of the result.
+ * @return  pattern repeated until size is reached.
+ */
+std::string Repeat(std::string const & pattern, std::size_t size) {
+    std::string result;
+    result.reserve(size + pattern.size());
+    while (result.size() < size) {
+        result += pattern;
+    }
+    return result;
+}
+
+
+/**
+ * @brief   Returns the hostile input shapes.
+ * @return  All adversarial shapes.
+ */
+std::vector<AdversarialShape> const & GetAdversarialShapes() {
+
+    static std::vector<AdversarialShape> const shapes{
+            {"long-host", [](std::size_t n) { return "http://" + Repeat("a", n) + "/"; }},
+            {"long-userinfo", [](std::size_t n) { return "http://" + Repeat("u:", n) + "@host/"; }},
+            {"long-ipv6", [](std::size_t n) { return "http://[" + Repeat("0:", n) + "]/"; }},
+            {"long-ipvfuture", [](std::size_t n) { return "http://[v1." + Repeat("a", n) + "]/"; }},
+            {"slashes", [](std::size_t n) { return "http://host" + Repeat("/", n); }},
+            {"ampersands", [](std::size_t n) { return "http://host/?" + Repeat("&", n); }},
+            {"dot-segments", [](std::size_t n) { return "http://host" + Repeat("/a/../..", n); }},
+            {"percent", [](std::size_t n) { return "http://host/" + Repeat("%41", n) + "?" + Repeat("%7e", n); }},
+            {"invalid-at-end", [](std::size_t n) { return "http://host/" + Repeat("a/", n) + " "; }},
+            {"quoted-schemes", [](std::size_t n) { return Repeat("'a://", n); }},
+            {"many-parameters", [](std::size_t n) {
+                 // distinct names in descending order: the worst case for sorting cache key parameters
+                 std::string url{"http://host/?"};
+                 for (std::size_t i = n / 8; i > 0; --i) {
+                     url += "p" + std::to_string(i) + "=1&";
+                 }
+                 return url;
+             }},
+    };
+    return shapes;
+}
+
+
+/**
+ * @brief   Runs a benchmark on a single input.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @param   category    category of the input.
+ * @param   input       the input.
+ * @param   f           the function to run on the input.
+ */
+template <typename F>
+void RunOnInput(std::ostream & out,
+                bench::Options const & options,
+                std::string const & name,
+                std::string const & category,
+                std::string const & input,
+                F && f) {
+
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+    auto result = bench::Run(options, name, category, 1, input.size(), [&]() { bench::DoNotOptimize(f(input)); });
+    bench::Report(out, options, result);
+}
+
+
+}
+
+
+void bench::RunAdversarialBenchmarks(std::ostream & out, Options const & options) {
+
+    // Parsing and normalizing is linear: the MiB/s of a shape must stay flat with growing size.
+    // With limits oversized input is rejected early: the time per URL stays flat instead.
+
+    headcode::url::ParseLimits limits{8192, 256, 256};
+    headcode::url::CacheKey cache_key;
+
+    for (auto const & shape : GetAdversarialShapes()) {
+        for (std::size_t size : {1024u, 16384u, 262144u}) {
+
+            auto input = shape.make_(size);
+            auto category = shape.name_ + "/" + std::to_string(size / 1024) + "K";
+
+            RunOnInput(out, options, "adversarial/URL::URL", category, input, [](std::string const & url) {
+                return headcode::url::URL{url}.GetError();
+            });
+            RunOnInput(out, options, "adversarial/URL::Normalize", category, input, [](std::string const & url) {
+                return headcode::url::URL{url}.Normalize().GetError();
+            });
+            RunOnInput(out, options, "adversarial/URL::URL(limits)", category, input, [&](std::string const & url) {
+                return headcode::url::URL{url, limits}.GetError();
+            });
+
+            RunOnInput(out, options, "adversarial/URLScanner::Next", category, input, [](std::string const & text) {
+                headcode::url::URLScanner scanner{text};
+                std::string_view url;
+                std::size_t found{0};
+                while (scanner.Next(url)) {
+                    ++found;
+                }
+                return found;
+            });
+
+            headcode::url::URL parsed{input};
+            RunOnInput(out, options, "adversarial/CacheKey::Hash", category, input, [&](std::string const &) {
+                return cache_key.Hash(parsed);
+            });
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#include "harness.hpp"
+
+
+namespace {
+
+/**
+ * @brief   A counter on a cache line of its own.
+ */
+struct alignas(64) AllocationCounter {
+    std::atomic<std::uint64_t> count_{0};        //!< @brief Number of allocations done.
+};
+
+
+/**
+ * @brief   Number of allocation counters.
+ */
+constexpr std::size_t kAllocationCounters = 64;
+
+
+/**
+ * @brief   The allocation counters, spread over threads.
+ *
+ * A single shared counter would make all threads contend on one cache line
+ * and distort the multi-threaded benchmarks.
+ */
+AllocationCounter allocation_counters[kAllocationCounters];
+
+
+/**
+ * @brief   Returns the allocation counter of the calling thread.
+ * @return  The allocation counter.
+ */
+AllocationCounter & GetThreadAllocationCounter() {
+    static std::atomic<std::size_t> next_thread{0};
+    thread_local std::size_t index = next_thread.fetch_add(1, std::memory_order_relaxed) % kAllocationCounters;
+    return allocation_counters[index];
+}
+
+}
+
+
+// Count all heap allocations of the process.
+
+void * operator new(std::size_t size) {
+    GetThreadAllocationCounter().count_.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+
+void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
+
+void operator delete(void * p, std::size_t) noexcept {
+    std::free(p);
+}
+
+
+std::uint64_t bench::GetAllocationCount() {
+    std::uint64_t count{0};
+    for (auto const & counter : allocation_counters) {
+        count += counter.count_.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+
+void bench::Report(std::ostream & out, Options const & options, Result const & result) {
+
+    double items = result.items_ ? static_cast<double>(result.items_) : 1.0;
+    double ns_per_item = static_cast<double>(result.nanoseconds_) / items;
+    double bytes_per_second = result.nanoseconds_
+                                      ? static_cast<double>(result.bytes_) * 1e9 / static_cast<double>(result.nanoseconds_)
+                                      : 0.0;
+    double allocations_per_item = static_cast<double>(result.allocations_) / items;
+
+    if (options.json_) {
+        out << std::fixed << std::setprecision(3) << "{\"benchmark\":\"" << result.name_ << "\",\"category\":\""
+            << result.category_ << "\",\"items\":" << result.items_ << ",\"bytes\":" << result.bytes_
+            << ",\"ns\":" << result.nanoseconds_ << ",\"ns_per_item\":" << ns_per_item
+            << ",\"bytes_per_second\":" << bytes_per_second << ",\"allocations_per_item\":" << allocations_per_item
+            << ",\"threads\":" << result.threads_ << ",\"parallel_efficiency\":" << result.parallel_efficiency_
+            << "}" << std::endl;
+        return;
+    }
+
+    out << std::left << std::setw(40) << result.name_ << std::setw(14) << result.category_ << std::right << std::fixed
+        << std::setprecision(1) << std::setw(12) << ns_per_item << " ns/item" << std::setw(12)
+        << bytes_per_second / (1024.0 * 1024.0) << " MiB/s" << std::setprecision(2) << std::setw(10)
+        << allocations_per_item << " allocs/item";
+    if (result.threads_ > 1) {
+        out << std::setprecision(1) << std::setw(8) << result.parallel_efficiency_ * 100.0 << " % efficiency";
+    }
+    out << std::endl;
+}
@@ -0,0 +1,160 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#ifndef HEADCODE_SPACE_URL_TEST_BENCHMARK_HARNESS_HPP
+#define HEADCODE_SPACE_URL_TEST_BENCHMARK_HARNESS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief   Benchmark helpers.
+ */
+namespace bench {
+
+
+/**
+ * @brief   The outcome of a single benchmark.
+ */
+struct Result {
+    std::string name_;                     //!< @brief Name of the benchmark.
+    std::string category_;                 //!< @brief Category of the input.
+    std::uint64_t items_{0};               //!< @brief Number of items (URLs, components, ...) processed.
+    std::uint64_t bytes_{0};               //!< @brief Number of input bytes processed.
+    std::uint64_t nanoseconds_{0};         //!< @brief Total run time.
+    std::uint64_t allocations_{0};         //!< @brief Number of heap allocations done.
+    unsigned int threads_{1};              //!< @brief Number of threads run.
+    double parallel_efficiency_{1.0};      //!< @brief Throughput relative to threads_ times a single thread.
+};
+
+
+/**
+ * @brief   Options of a benchmark run.
+ */
+struct Options {
+    std::uint64_t min_nanoseconds_{200'000'000};        //!< @brief Minimum run time of each benchmark.
+    std::string filter_;                                //!< @brief Run only benchmarks containing this.
+    bool json_{false};                                  //!< @brief Report as JSON lines.
+    unsigned int max_threads_{0};                       //!< @brief Maximum number of threads (0: hardware).
+};
+
+
+/**
+ * @brief   Returns the number of heap allocations done so far (by all threads).
+ * @return  The number of calls to operator new.
+ */
+std::uint64_t GetAllocationCount();
+
+
+/**
+ * @brief   Prevents the compiler from optimizing away a value.
+ * @param   value       the value to keep.
+ */
+template <typename T>
+inline void DoNotOptimize(T const & value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+
+/**
+ * @brief   Runs a benchmark.
+ *
+ * The function f processes a whole round of input (i.e. items and bytes)
+ * and is called repeatedly until the minimum run time is reached.
+ *
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @param   category    category of the input.
+ * @param   items       number of items processed per round.
+ * @param   bytes       number of bytes processed per round.
+ * @param   f           the function to call for a round.
+ * @return  The benchmark result.
+ */
+template <typename F>
+inline Result Run(Options const & options,
+                  std::string name,
+                  std::string category,
+                  std::uint64_t items,
+                  std::uint64_t bytes,
+                  F && f) {
+
+    Result result{std::move(name), std::move(category)};
+
+    f();        // warm up
+
+    auto allocations_start = GetAllocationCount();
+    auto time_start = std::chrono::steady_clock::now();
+    std::uint64_t rounds{0};
+    do {
+        f();
+        ++rounds;
+        result.nanoseconds_ = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start)
+                        .count());
+    } while (result.nanoseconds_ < options.min_nanoseconds_);
+
+    result.allocations_ = GetAllocationCount() - allocations_start;
+    result.items_ = items * rounds;
+    result.bytes_ = bytes * rounds;
+
+    return result;
+}
+
+
+/**
+ * @brief   Checks if a benchmark is selected by the filter.
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @return  true, if the benchmark should run.
+ */
+inline bool IsSelected(Options const & options, std::string const & name) {
+    return options.filter_.empty() || (name.find(options.filter_) != std::string::npos);
+}
+
+
+/**
+ * @brief   Writes a single result.
+ * @param   out         the stream to write to.
+ * @param   options     the benchmark options (selecting the format).
+ * @param   result      the result to write.
+ */
+void Report(std::ostream & out, Options const & options, Result const & result);
+
+
+/**
+ * @brief   Runs the benchmarks of each parser stage over the corpus.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ */
+void RunStageBenchmarks(std::ostream & out, Options const & options);
+
+
+/**
+ * @brief   Runs the multi-threaded scaling benchmarks over the corpus.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ */
+void RunScalingBenchmarks(std::ostream & out, Options const & options);
+
+
+/**
+ * @brief   Runs the benchmarks on hostile input of growing size.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ */
+void RunAdversarialBenchmarks(std::ostream & out, Options const & options);
+
+
+}
+
+
+#endif
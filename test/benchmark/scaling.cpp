@@ -0,0 +1,206 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <atomic>
+#include <thread>
+
+#include <headcode/url/url.hpp>
+
+#include "corpus.hpp"
+#include "harness.hpp"
+
+
+namespace {
+
+
+/**
+ * @brief   How each thread parses its URLs.
+ */
+enum class ParseMode {
+    kConstruct = 0,        //!< @brief A new URL object per URL.
+    kReuse,                //!< @brief One URL object per thread, reused with Assign().
+    kCache                 //!< @brief Looked up in a URLCache shared by all threads.
+};
+
+
+/**
+ * @brief   Time and allocations of a multi-threaded run.
+ */
+struct Measurement {
+    std::uint64_t nanoseconds_{0};        //!< @brief Wall clock time of the run.
+    std::uint64_t allocations_{0};        //!< @brief Heap allocations of all threads.
+};
+
+
+/**
+ * @brief   Creates the input slice of a thread: the corpus rotated by the thread index.
+ * @param   thread      the thread index.
+ * @return  The URLs of the thread (in memory allocated by the thread itself).
+ */
+std::vector<std::string> MakeSlice(std::size_t thread) {
+    auto const & corpus = bench::GetCorpus();
+    std::vector<std::string> slice;
+    slice.reserve(corpus.size());
+    for (std::size_t i = 0; i < corpus.size(); ++i) {
+        slice.push_back(corpus[(i + thread) % corpus.size()].url_);
+    }
+    return slice;
+}
+
+
+/**
+ * @brief   Parses all URLs of a slice.
+ * @param   slice       the URLs to parse.
+ * @param   mode        how to parse.
+ * @param   url         the URL object to reuse (kReuse).
+ * @param   cache       the cache to look up (kCache).
+ */
+void ParseSlice(std::vector<std::string> const & slice,
+                ParseMode mode,
+                headcode::url::URL & url,
+                headcode::url::URLCache & cache) {
+    for (auto const & raw : slice) {
+        if (mode == ParseMode::kReuse) {
+            url.Assign(raw);
+            bench::DoNotOptimize(url.GetError());
+        } else if (mode == ParseMode::kCache) {
+            auto cached = cache.Get(raw);
+            bench::DoNotOptimize(cached->GetError());
+        } else {
+            headcode::url::URL parsed{raw};
+            bench::DoNotOptimize(parsed.GetError());
+        }
+    }
+}
+
+
+/**
+ * @brief   Parses the corpus on a number of threads, each on its own slice.
+ * @param   threads     number of threads.
+ * @param   mode        how to parse.
+ * @param   rounds      number of times each thread parses its slice.
+ * @return  The measurement of the run.
+ */
+Measurement RunThreads(unsigned int threads, ParseMode mode, std::uint64_t rounds) {
+
+    std::atomic<unsigned int> ready{0};
+    std::atomic<bool> start{false};
+    headcode::url::URLCache cache{bench::GetCorpus().size() * 2};        // room for an uneven spread on the shards
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            auto slice = MakeSlice(t);
+            headcode::url::URL url;
+            ParseSlice(slice, mode, url, cache);        // warm up
+            ready.fetch_add(1);
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (std::uint64_t r = 0; r < rounds; ++r) {
+                ParseSlice(slice, mode, url, cache);
+            }
+        });
+    }
+
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+
+    Measurement measurement;
+    auto allocations_start = bench::GetAllocationCount();
+    auto time_start = std::chrono::steady_clock::now();
+    start.store(true);
+    for (auto & worker : workers) {
+        worker.join();
+    }
+    measurement.nanoseconds_ = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start)
+                    .count());
+    measurement.allocations_ = bench::GetAllocationCount() - allocations_start;
+
+    return measurement;
+}
+
+
+/**
+ * @brief   Returns the thread counts to run: 1, 2, 4, ... up to the maximum.
+ * @param   options     the benchmark options.
+ * @return  The thread counts.
+ */
+std::vector<unsigned int> GetThreadCounts(bench::Options const & options) {
+
+    unsigned int max_threads = options.max_threads_;
+    if (max_threads == 0) {
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<unsigned int> counts;
+    for (unsigned int threads = 1; threads < max_threads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+
+/**
+ * @brief   Runs the scaling benchmark of a single parse mode.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @param   mode        how to parse.
+ */
+void RunScaling(std::ostream & out, bench::Options const & options, std::string const & name, ParseMode mode) {
+
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+
+    auto const & corpus = bench::GetCorpus();
+    std::uint64_t items = corpus.size();
+    std::uint64_t bytes{0};
+    for (auto const & entry : corpus) {
+        bytes += entry.url_.size();
+    }
+
+    // calibrate the rounds on a single thread, then every thread does the same work (weak scaling)
+    std::uint64_t rounds{1};
+    auto single = RunThreads(1, mode, rounds);
+    while (single.nanoseconds_ < options.min_nanoseconds_) {
+        rounds *= 2;
+        single = RunThreads(1, mode, rounds);
+    }
+    double single_throughput = static_cast<double>(items * rounds) / static_cast<double>(single.nanoseconds_);
+
+    for (auto threads : GetThreadCounts(options)) {
+
+        auto measurement = threads == 1 ? single : RunThreads(threads, mode, rounds);
+
+        bench::Result result{name, "threads=" + std::to_string(threads)};
+        result.items_ = items * rounds * threads;
+        result.bytes_ = bytes * rounds * threads;
+        result.nanoseconds_ = measurement.nanoseconds_;
+        result.allocations_ = measurement.allocations_;
+        result.threads_ = threads;
+        double throughput = static_cast<double>(result.items_) / static_cast<double>(result.nanoseconds_);
+        result.parallel_efficiency_ = throughput / (single_throughput * threads);
+
+        bench::Report(out, options, result);
+    }
+}
+
+
+}
+
+
+void bench::RunScalingBenchmarks(std::ostream & out, Options const & options) {
+    RunScaling(out, options, "scaling/URL::URL", ParseMode::kConstruct);
+    RunScaling(out, options, "scaling/URL::Assign", ParseMode::kReuse);
+    RunScaling(out, options, "scaling/URLCache::Get", ParseMode::kCache);
+}
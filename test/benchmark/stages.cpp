@@ -0,0 +1,555 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <array>
+#include <map>
+#include <string_view>
+
+#include <headcode/url/url.hpp>
+
+#include "corpus.hpp"
+#include "harness.hpp"
+
+
+namespace {
+
+
+/**
+ * @brief   Components of the valid corpus URLs used as input for the single stages.
+ */
+struct StageInput {
+    std::vector<headcode::url::URL> urls_;                   //!< @brief All valid URLs.
+    std::vector<std::string_view> hosts_;                    //!< @brief All non-empty hosts.
+    std::vector<std::string_view> ipv6_hosts_;               //!< @brief All IPv6 hosts.
+    std::vector<std::string_view> userinfos_;                //!< @brief All non-empty userinfos.
+    std::vector<std::string_view> ports_;                    //!< @brief All non-empty ports.
+    std::vector<std::string_view> authorities_;              //!< @brief All non-empty authorities.
+    std::vector<std::string_view> segments_;                 //!< @brief All path segments.
+    std::vector<std::string_view> queries_;                  //!< @brief All non-empty queries.
+    std::vector<std::string_view> fragments_;                //!< @brief All non-empty fragments.
+};
+
+
+/**
+ * @brief   Sums up the sizes of strings.
+ * @param   values      the strings.
+ * @return  The total number of bytes.
+ */
+template <typename T>
+std::uint64_t SumBytes(std::vector<T> const & values) {
+    std::uint64_t bytes{0};
+    for (auto const & value : values) {
+        bytes += std::string_view{value}.size();
+    }
+    return bytes;
+}
+
+
+/**
+ * @brief   Offset of a component inside the URL.
+ * @param   url         the URL.
+ * @param   component   the component (a view into the URL).
+ * @return  The start index of the component.
+ */
+std::size_t OffsetOf(headcode::url::URL const & url, std::string_view component) {
+    return static_cast<std::size_t>(component.data() - url.GetURL().data());
+}
+
+
+/**
+ * @brief   Collects the input of the stage benchmarks.
+ * @return  The stage input.
+ */
+StageInput CollectStageInput() {
+
+    StageInput input;
+    for (auto const & entry : bench::GetCorpus()) {
+        headcode::url::URL url{entry.url_};
+        if (url.IsValid()) {
+            input.urls_.push_back(url);
+        }
+    }
+
+    for (auto const & url : input.urls_) {
+
+        auto add = [](std::vector<std::string_view> & values, std::string_view value) {
+            if (!value.empty()) {
+                values.push_back(value);
+            }
+        };
+
+        add(input.hosts_, url.GetHost());
+        if (url.GetHostType() == headcode::url::HostType::kIPv6) {
+            input.ipv6_hosts_.push_back(url.GetHost());
+        }
+        add(input.userinfos_, url.GetUserInfo());
+        add(input.ports_, url.GetPort());
+        add(input.authorities_, url.GetAuthority());
+        for (auto const & segment : url.GetSegments()) {
+            input.segments_.push_back(segment);
+        }
+        add(input.queries_, url.GetQuery());
+        add(input.fragments_, url.GetFragment());
+    }
+
+    return input;
+}
+
+
+/**
+ * @brief   Runs a benchmark calling a predicate on each value.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @param   values      the input values.
+ * @param   f           the function to call on each value.
+ */
+template <typename F>
+void RunOnEach(std::ostream & out,
+               bench::Options const & options,
+               std::string const & name,
+               std::vector<std::string_view> const & values,
+               F && f) {
+
+    if (!bench::IsSelected(options, name) || values.empty()) {
+        return;
+    }
+    auto result = bench::Run(options, name, "all", values.size(), SumBytes(values), [&]() {
+        for (auto const & value : values) {
+            bench::DoNotOptimize(f(value));
+        }
+    });
+    bench::Report(out, options, result);
+}
+
+
+/**
+ * @brief   Runs a benchmark calling an accessor on each valid URL.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   name        name of the benchmark.
+ * @param   urls        the URLs.
+ * @param   f           the accessor to call.
+ */
+template <typename F>
+void RunOnURLs(std::ostream & out,
+               bench::Options const & options,
+               std::string const & name,
+               std::vector<headcode::url::URL> const & urls,
+               F && f) {
+
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+
+    std::uint64_t bytes{0};
+    for (auto const & url : urls) {
+        bytes += url.GetURL().size();
+    }
+    auto result = bench::Run(options, name, "all", urls.size(), bytes, [&]() {
+        for (auto const & url : urls) {
+            bench::DoNotOptimize(f(url));
+        }
+    });
+    bench::Report(out, options, result);
+}
+
+
+/**
+ * @brief   Benchmarks the URL construction per corpus category.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ */
+void RunConstruction(std::ostream & out, bench::Options const & options) {
+
+    std::string name{"URL::URL"};
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+
+    std::map<std::string, std::vector<std::string>> by_category;
+    for (auto const & entry : bench::GetCorpus()) {
+        by_category[entry.category_].push_back(entry.url_);
+        by_category["all"].push_back(entry.url_);
+    }
+
+    for (auto const & [category, urls] : by_category) {
+        auto result = bench::Run(options, name, category, urls.size(), SumBytes(urls), [&]() {
+            for (auto const & url : urls) {
+                headcode::url::URL parsed{url};
+                bench::DoNotOptimize(parsed.GetError());
+            }
+        });
+        bench::Report(out, options, result);
+    }
+}
+
+
+/**
+ * @brief   Benchmarks the URL construction of trusted input.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunTrustedConstruction(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    std::string name{"URL::URL(trusted)"};
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+
+    std::vector<std::string> urls;
+    for (auto const & url : input.urls_) {
+        urls.push_back(url.GetURL());
+    }
+    auto result = bench::Run(options, name, "valid", urls.size(), SumBytes(urls), [&]() {
+        for (auto const & url : urls) {
+            headcode::url::URL parsed{url, headcode::url::kTrustedInput};
+            bench::DoNotOptimize(parsed.GetError());
+        }
+    });
+    bench::Report(out, options, result);
+}
+
+
+/**
+ * @brief   Benchmarks the cache keys of valid URLs (all parameters, sorted).
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunCacheKeys(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    headcode::url::CacheKey key;
+    RunOnURLs(out, options, "CacheKey::Write", input.urls_, [&](headcode::url::URL const & u) {
+        std::array<char, 1024> buffer;
+        return key.Write(u, buffer.data(), buffer.size());
+    });
+    RunOnURLs(out, options, "CacheKey::Hash", input.urls_, [&](headcode::url::URL const & u) { return key.Hash(u); });
+}
+
+
+/**
+ * @brief   Benchmarks stripping tracking parameters (on a copy reusing its memory).
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunParameterMatcher(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    headcode::url::ParameterMatcher matcher{"utm_*\nfbclid\ngclid\nmc_eid\nmsclkid\n_ga\nref"};
+    headcode::url::URL copy;
+    RunOnURLs(out, options, "ParameterMatcher::Strip", input.urls_, [&](headcode::url::URL const & u) {
+        copy = u;
+        return matcher.Strip(copy);
+    });
+}
+
+/**
+ * @brief   Benchmarks URLScanner on a log-like document holding all valid URLs of the corpus.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunScanner(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    std::string text;
+    for (auto const & url : input.urls_) {
+        text += "2021-01-01 12:00:00 INFO <a href=\"" + url.GetURL() + "\">fetched</a> in 12 ms.\n";
+    }
+
+    auto run = [&](std::string const & name, auto && scan) {
+        if (!bench::IsSelected(options, name)) {
+            return;
+        }
+        auto result = bench::Run(options, name, "all", input.urls_.size(), text.size(), [&]() {
+            headcode::url::URLScanner scanner{text};
+            bench::DoNotOptimize(scan(scanner));
+        });
+        bench::Report(out, options, result);
+    };
+
+    run("URLScanner::Next", [](headcode::url::URLScanner & scanner) {
+        std::string_view url;
+        std::size_t found{0};
+        while (scanner.Next(url)) {
+            ++found;
+        }
+        return found;
+    });
+    headcode::url::URL parsed;
+    run("URLScanner::Next(URL)", [&](headcode::url::URLScanner & scanner) {
+        std::size_t found{0};
+        while (scanner.Next(parsed)) {
+            ++found;
+        }
+        return found;
+    });
+}
+
+/**
+ * @brief   Benchmarks RequestTarget on the origin-form (path and query) of all valid URLs of the corpus
+ *          against building and parsing an absolute URL, and on the absolute-form.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunRequestTargets(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    std::vector<std::string> targets;
+    for (auto const & url : input.urls_) {
+        std::string target{url.GetPath()};
+        if (target.empty() || (target[0] != '/')) {
+            target.insert(target.begin(), '/');
+        }
+        if (url.IsQueryPresent()) {
+            target += '?';
+            target += url.GetQuery();
+        }
+        targets.push_back(std::move(target));
+    }
+    std::vector<std::string_view> origin_forms{targets.begin(), targets.end()};
+    std::vector<std::string_view> absolute_forms;
+    for (auto const & url : input.urls_) {
+        absolute_forms.push_back(url.GetURL());
+    }
+
+    RunOnEach(out, options, "RequestTarget(origin)", origin_forms, [](std::string_view target) {
+        return headcode::url::RequestTarget{target}.IsValid();
+    });
+    std::string absolute;
+    RunOnEach(out, options, "URL(http://host + origin)", origin_forms, [&](std::string_view target) {
+        absolute.assign("http://host");
+        absolute += target;
+        return headcode::url::URL{absolute}.IsValid();
+    });
+    RunOnEach(out, options, "RequestTarget(absolute)", absolute_forms, [](std::string_view target) {
+        return headcode::url::RequestTarget{target}.IsValid();
+    });
+}
+
+/**
+ * @brief   Benchmarks URLStreamParser on all valid URLs of the corpus, fed whole and in chunks of 16 bytes.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunStreamParser(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    headcode::url::URLStreamParser parser;
+    RunOnURLs(out, options, "URLStreamParser(whole)", input.urls_, [&](headcode::url::URL const & u) {
+        parser.Reset();
+        parser.Feed(u.GetURL());
+        return parser.Finish();
+    });
+    RunOnURLs(out, options, "URLStreamParser(16 byte chunks)", input.urls_, [&](headcode::url::URL const & u) {
+        std::string_view url{u.GetURL()};
+        parser.Reset();
+        for (std::size_t i = 0; i < url.size(); i += 16) {
+            parser.Feed(url.substr(i, 16));
+        }
+        return parser.Finish();
+    });
+}
+
+/**
+ * @brief   Stops the scan after the host.
+ */
+struct HostVisitor : headcode::url::URLVisitor {
+    bool OnHost(std::string_view, headcode::url::HostAddress const &) {
+        return false;
+    }
+};
+
+
+/**
+ * @brief   Benchmarks VisitURL() on valid URLs: a full scan and a scan stopped after the host.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunVisits(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    RunOnURLs(out, options, "VisitURL", input.urls_, [](headcode::url::URL const & u) {
+        headcode::url::URLVisitor visitor;
+        return headcode::url::VisitURL(u.GetURL(), visitor);
+    });
+    RunOnURLs(out, options, "VisitURL(host)", input.urls_, [](headcode::url::URL const & u) {
+        HostVisitor visitor;
+        return headcode::url::VisitURL(u.GetURL(), visitor);
+    });
+}
+
+
+/**
+ * @brief   Benchmarks copying parsed URLs: deep copies of URL against shared copies of SharedURL.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunCopies(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    RunOnURLs(out, options, "URL::URL(copy)", input.urls_, [](headcode::url::URL const & u) {
+        headcode::url::URL copy{u};
+        return copy.GetError();
+    });
+
+    std::string name{"SharedURL::SharedURL(copy)"};
+    if (!bench::IsSelected(options, name)) {
+        return;
+    }
+
+    std::vector<headcode::url::SharedURL> urls;
+    std::uint64_t bytes{0};
+    for (auto const & url : input.urls_) {
+        urls.emplace_back(url);
+        bytes += url.GetURL().size();
+    }
+    auto result = bench::Run(options, name, "all", urls.size(), bytes, [&]() {
+        for (auto const & url : urls) {
+            headcode::url::SharedURL copy{url};
+            bench::DoNotOptimize(copy->GetError());
+        }
+    });
+    bench::Report(out, options, result);
+}
+
+
+/**
+ * @brief   Benchmarks the impl::Parse* functions.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunParseStages(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    using namespace headcode::url;
+
+    std::pair<std::size_t, std::size_t> p1;
+    std::pair<std::size_t, std::size_t> p2;
+    std::pair<std::size_t, std::size_t> p3;
+    std::pair<std::size_t, std::size_t> p4;
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    HostAddress host_address;
+    SchemeKind scheme_kind;
+    std::uint16_t port_number;
+
+    RunOnURLs(out, options, "impl::ParseScheme", input.urls_, [&](URL const & url) {
+        return std::get<0>(impl::ParseScheme(url.GetURL(), 0, p1, scheme_kind));
+    });
+
+    RunOnURLs(out, options, "impl::ParseAuthority", input.urls_, [&](URL const & url) {
+        return std::get<0>(impl::ParseAuthority(
+                url.GetURL(), OffsetOf(url, url.GetAuthority()), p1, p2, p3, host_address, p4, port_number));
+    });
+
+    RunOnEach(out, options, "impl::ParsePort", input.authorities_, [&](std::string_view authority) {
+        return impl::ParsePort(authority, p1);
+    });
+
+    RunOnURLs(out, options, "impl::ParsePath", input.urls_, [&](URL const & url) {
+        return std::get<0>(impl::ParsePath(
+                url.GetURL(), OffsetOf(url, url.GetPath()), !url.GetAuthority().empty(), p1, pairs));
+    });
+
+    RunOnURLs(out, options, "impl::ParseQuery", input.urls_, [&](URL const & url) {
+        pairs.clear();
+        return std::get<0>(impl::ParseQuery(url.GetURL(), OffsetOf(url, url.GetQuery()), p1, pairs));
+    });
+
+    RunOnURLs(out, options, "impl::ParseFragment", input.urls_, [&](URL const & url) {
+        return std::get<0>(impl::ParseFragment(url.GetURL(), OffsetOf(url, url.GetFragment()), p1));
+    });
+}
+
+
+/**
+ * @brief   Benchmarks the impl::Is* functions.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunValidators(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    using namespace headcode::url;
+
+    RunOnEach(out, options, "impl::IsIPv4", input.hosts_, [](auto v) { return impl::IsIPv4(v); });
+    RunOnEach(out, options, "impl::IsIPv6", input.ipv6_hosts_, [](auto v) { return impl::IsIPv6(v); });
+    RunOnEach(out, options, "impl::IsIPvFuture", input.hosts_, [](auto v) { return impl::IsIPvFuture(v); });
+    RunOnEach(out, options, "impl::IsRegName", input.hosts_, [](auto v) { return impl::IsRegName(v); });
+    RunOnEach(out, options, "impl::IsValidHost", input.hosts_, [](auto v) { return impl::IsValidHost(v); });
+    RunOnEach(out, options, "impl::IsValidUserInfo", input.userinfos_, [](auto v) {
+        return impl::IsValidUserInfo(v);
+    });
+    RunOnEach(out, options, "impl::IsValidPort", input.ports_, [](auto v) { return impl::IsValidPort(v); });
+    RunOnEach(out, options, "impl::IsValidPathSegment", input.segments_, [](auto v) {
+        return impl::IsValidPathSegment(v);
+    });
+    RunOnEach(out, options, "impl::IsValidQuery", input.queries_, [](auto v) { return impl::IsValidQuery(v); });
+    RunOnEach(out, options, "impl::IsValidFragment", input.fragments_, [](auto v) {
+        return impl::IsValidFragment(v);
+    });
+}
+
+
+/**
+ * @brief   Benchmarks the URL accessors and operations.
+ * @param   out         the stream to report to.
+ * @param   options     the benchmark options.
+ * @param   input       the stage input.
+ */
+void RunAccessors(std::ostream & out, bench::Options const & options, StageInput const & input) {
+
+    using headcode::url::URL;
+
+    RunOnURLs(out, options, "URL::GetScheme", input.urls_, [](URL const & u) { return u.GetScheme(); });
+    RunOnURLs(out, options, "URL::GetSchemeKind", input.urls_, [](URL const & u) { return u.GetSchemeKind(); });
+    RunOnURLs(out, options, "URL::GetAuthority", input.urls_, [](URL const & u) { return u.GetAuthority(); });
+    RunOnURLs(out, options, "URL::GetUserInfo", input.urls_, [](URL const & u) { return u.GetUserInfo(); });
+    RunOnURLs(out, options, "URL::GetHost", input.urls_, [](URL const & u) { return u.GetHost(); });
+    RunOnURLs(out, options, "URL::GetHostType", input.urls_, [](URL const & u) { return u.GetHostType(); });
+    RunOnURLs(out, options, "URL::GetPort", input.urls_, [](URL const & u) { return u.GetPort(); });
+    RunOnURLs(out, options, "URL::GetPortNumber", input.urls_, [](URL const & u) { return u.GetPortNumber(); });
+    RunOnURLs(out, options, "URL::GetEffectivePort", input.urls_, [](URL const & u) {
+        return u.GetEffectivePort();
+    });
+    RunOnURLs(out, options, "URL::GetPath", input.urls_, [](URL const & u) { return u.GetPath(); });
+    RunOnURLs(out, options, "URL::GetPathPart", input.urls_, [](URL const & u) { return u.GetPathPart(1); });
+    RunOnURLs(out, options, "URL::GetQuery", input.urls_, [](URL const & u) { return u.GetQuery(); });
+    RunOnURLs(out, options, "URL::GetFragment", input.urls_, [](URL const & u) { return u.GetFragment(); });
+    RunOnURLs(out, options, "URL::GetSegments", input.urls_, [](URL const & u) { return u.GetSegments().size(); });
+    RunOnURLs(out, options, "URL::Segments", input.urls_, [](URL const & u) { return u.Segments().size(); });
+    RunOnURLs(out, options, "URL::QueryItems", input.urls_, [](URL const & u) { return u.QueryItems().size(); });
+    RunOnURLs(out, options, "URL::GetQueryItems", input.urls_, [](URL const & u) {
+        return u.GetQueryItems().size();
+    });
+    RunOnURLs(out, options, "URL::IsHost", input.urls_, [](URL const & u) { return u.IsHost(u.GetHost()); });
+    RunOnURLs(out, options, "URL::Normalize", input.urls_, [](URL const & u) { return u.Normalize().IsValid(); });
+}
+
+
+}
+
+
+void bench::RunStageBenchmarks(std::ostream & out, Options const & options) {
+
+    auto input = CollectStageInput();
+
+    RunConstruction(out, options);
+    RunTrustedConstruction(out, options, input);
+    RunCopies(out, options, input);
+    RunVisits(out, options, input);
+    RunCacheKeys(out, options, input);
+    RunParameterMatcher(out, options, input);
+    RunScanner(out, options, input);
+    RunRequestTargets(out, options, input);
+    RunStreamParser(out, options, input);
+    RunAccessors(out, options, input);
+    RunParseStages(out, options, input);
+    RunValidators(out, options, input);
+}
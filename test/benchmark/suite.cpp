@@ -0,0 +1,58 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "harness.hpp"
+
+
+/**
+ * @brief   Prints the usage.
+ */
+static void Usage() {
+    std::cout << "Usage: benchmark-suite [--json] [--filter=TEXT] [--min-time=MS] [--threads=N]\n"
+                 "\n"
+                 "Runs the hcs-url benchmarks over the bundled URL corpus and reports\n"
+                 "ns/item, throughput and heap allocations/item of each benchmark.\n"
+                 "\n"
+                 "  --json           report as JSON lines (one object per benchmark).\n"
+                 "  --filter=TEXT    run only benchmarks whose name contains TEXT.\n"
+                 "  --min-time=MS    minimum run time of each benchmark in milliseconds (default: 200).\n"
+                 "  --threads=N      maximum number of threads of the scaling benchmarks (default: all cores).\n"
+              << std::endl;
+}
+
+
+int main(int argc, char ** argv) {
+
+    bench::Options options;
+    for (int i = 1; i < argc; ++i) {
+
+        std::string arg{argv[i]};
+        if (arg == "--json") {
+            options.json_ = true;
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            options.filter_ = arg.substr(9);
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            options.min_nanoseconds_ = std::strtoull(arg.substr(11).c_str(), nullptr, 10) * 1'000'000;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            options.max_threads_ = static_cast<unsigned int>(std::strtoul(arg.substr(10).c_str(), nullptr, 10));
+        } else {
+            Usage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    bench::RunStageBenchmarks(std::cout, options);
+    bench::RunScalingBenchmarks(std::cout, options);
+    bench::RunAdversarialBenchmarks(std::cout, options);
+
+    return 0;
+}
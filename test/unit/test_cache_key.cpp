@@ -0,0 +1,121 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <array>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+TEST(CacheKey, canonical) {
+
+    headcode::url::CacheKey key;
+
+    EXPECT_EQ(key.Build(headcode::url::URL{"HTTP://user@WWW.Example.COM:80/A/b?y=2&x=1&&x=0#top"}),
+              "http://www.example.com/A/b?x=0&x=1&y=2");
+    EXPECT_EQ(key.Build(headcode::url::URL{"https://example.com:8443"}), "https://example.com:8443/");
+    EXPECT_EQ(key.Build(headcode::url::URL{"https://example.com:443?"}), "https://example.com/");
+    EXPECT_EQ(key.Build(headcode::url::URL{"http://[2001:DB8::7]:8080/"}), "http://[2001:db8::7]:8080/");
+    EXPECT_EQ(key.Build(headcode::url::URL{"http://host/?b&a=2&a=1&a=1&a"}), "http://host/?a&a=1&a=1&a=2&b");
+
+    // sorted by name first: "a-b" sorts after "a" though '-' sorts before '='
+    EXPECT_EQ(key.Build(headcode::url::URL{"http://host/?a-b=1&a=1"}), "http://host/?a=1&a-b=1");
+}
+
+
+TEST(CacheKey, many_parameters) {
+
+    // more parameters than sorted on the stack
+    std::string query;
+    std::string expected;
+    for (int i = 299; i >= 0; --i) {
+        query += "&p" + std::to_string(1000 + i) + "=" + std::to_string(i % 7);
+        expected = "&p" + std::to_string(1000 + i) + "=" + std::to_string(i % 7) + expected;
+    }
+    query += "&p1000=0";
+    expected.insert(8, "&p1000=0");
+    expected[0] = '?';
+
+    headcode::url::CacheKey key;
+    EXPECT_EQ(key.Build(headcode::url::URL{"http://host/?" + query.substr(1)}), "http://host/" + expected);
+}
+
+
+TEST(CacheKey, filter) {
+
+    headcode::url::CacheKeyOptions allow;
+    allow.filter_ = headcode::url::ParameterFilter::kAllow;
+    allow.parameters_ = {"page", "id"};
+    headcode::url::CacheKey allow_key{allow};
+    EXPECT_EQ(allow_key.Build(headcode::url::URL{"http://host/p?utm_source=x&page=2&id=7&ID=8"}),
+              "http://host/p?id=7&page=2");
+    EXPECT_EQ(allow_key.Build(headcode::url::URL{"http://host/p?utm_source=x"}), "http://host/p");
+
+    headcode::url::CacheKeyOptions deny;
+    deny.filter_ = headcode::url::ParameterFilter::kDeny;
+    deny.parameters_ = {"utm_source", "utm_medium"};
+    deny.sort_parameters_ = false;
+    headcode::url::CacheKey deny_key{deny};
+    EXPECT_EQ(deny_key.Build(headcode::url::URL{"http://host/p?z=1&utm_source=x&a=2&utm_medium=y"}),
+              "http://host/p?z=1&a=2");
+
+    headcode::url::CacheKeyOptions none;
+    none.filter_ = headcode::url::ParameterFilter::kNone;
+    EXPECT_EQ(headcode::url::CacheKey{none}.Build(headcode::url::URL{"http://host/p?a=1"}), "http://host/p");
+}
+
+
+TEST(CacheKey, case) {
+
+    headcode::url::CacheKeyOptions options;
+    options.filter_ = headcode::url::ParameterFilter::kAllow;
+    options.parameters_ = {"Page"};
+    options.ignore_parameter_case_ = true;
+    options.lowercase_path_ = true;
+    headcode::url::CacheKey key{options};
+    EXPECT_EQ(key.Build(headcode::url::URL{"http://host/Some/Path?PAGE=A&x=1&page=b"}),
+              "http://host/some/path?page=A&page=b");
+}
+
+
+TEST(CacheKey, buffer) {
+
+    headcode::url::CacheKey key;
+    headcode::url::URL url{"http://host/path?b=2&a=1"};
+
+    std::array<char, 64> buffer{};
+    auto length = key.Write(url, buffer.data(), buffer.size());
+    EXPECT_EQ(std::string_view(buffer.data(), length), "http://host/path?a=1&b=2");
+
+    // too small: truncated, but the full length is returned
+    std::array<char, 10> small{};
+    EXPECT_EQ(key.Write(url, small.data(), small.size()), length);
+    EXPECT_EQ(std::string_view(small.data(), small.size()), "http://hos");
+    EXPECT_EQ(key.Write(url, nullptr, 0), length);
+}
+
+
+TEST(CacheKey, hash) {
+
+    headcode::url::CacheKey key;
+    headcode::url::URL url1{"HTTP://Host:80/path?b=2&a=1#x"};
+    headcode::url::URL url2{"http://host/path?a=1&b=2"};
+    headcode::url::URL url3{"http://host/path?a=1&b=3"};
+
+    EXPECT_EQ(key.Hash(url1), key.Hash(url2));
+    EXPECT_NE(key.Hash(url1), key.Hash(url3));
+
+    // 64 bit FNV-1a of the key
+    std::uint64_t hash{14695981039346656037ull};
+    for (auto c : key.Build(url2)) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    EXPECT_EQ(key.Hash(url2), hash);
+}
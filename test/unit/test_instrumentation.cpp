@@ -0,0 +1,103 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+// This test is built with HEADCODE_SPACE_URL_INSTRUMENTATION defined (see CMakeLists.txt).
+
+
+TEST(Instrumentation, stage_names) {
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kScheme), "scheme");
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kAuthority), "authority");
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kPath), "path");
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kQuery), "query");
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kFragment), "fragment");
+    EXPECT_STREQ(headcode::url::GetParseStageName(headcode::url::ParseStage::kNormalize), "normalize");
+}
+
+
+TEST(Instrumentation, counters) {
+
+    if (!headcode::url::IsInstrumentationEnabled()) {
+        GTEST_SKIP();
+    }
+
+    using headcode::url::ParseError;
+    using headcode::url::ParseStage;
+
+    headcode::url::ResetParseStatistics();
+
+    headcode::url::URL{"https://user@www.example.com:8080/a/b/c?foo&bar#fragment"};
+    headcode::url::URL{"https://www.example.com/path"};
+    headcode::url::URL{"http://host:1234/bad/path /"};
+    headcode::url::URL{""};
+    auto normalized = headcode::url::URL{"HTTP://www.example.com/a/./b"}.Normalize();
+    EXPECT_TRUE(normalized.IsValid());
+
+    auto statistics = headcode::url::GetParseStatistics();
+    auto stage = [&](ParseStage s) { return statistics.stages_[static_cast<std::size_t>(s)].count_; };
+    auto error = [&](ParseError e) { return statistics.errors_[static_cast<std::size_t>(e)]; };
+
+    // 5 URLs + the normalized one
+    EXPECT_EQ(statistics.parses_, 6u);
+    EXPECT_EQ(error(ParseError::kNoError), 4u);
+    EXPECT_EQ(error(ParseError::kInvalidPath), 1u);
+    EXPECT_EQ(error(ParseError::kURLEmpty), 1u);
+
+    EXPECT_EQ(stage(ParseStage::kScheme), 5u);
+    EXPECT_EQ(stage(ParseStage::kAuthority), 5u);
+    EXPECT_EQ(stage(ParseStage::kPath), 5u);
+    EXPECT_EQ(stage(ParseStage::kQuery), 1u);
+    EXPECT_EQ(stage(ParseStage::kFragment), 1u);
+    EXPECT_EQ(stage(ParseStage::kNormalize), 1u);
+
+    // the segments and query items of the URLs
+    EXPECT_GT(statistics.offset_allocations_, 0u);
+    EXPECT_GT(statistics.offset_allocated_bytes_, 0u);
+
+    headcode::url::ResetParseStatistics();
+    statistics = headcode::url::GetParseStatistics();
+    EXPECT_EQ(statistics.parses_, 0u);
+    EXPECT_EQ(statistics.offset_allocations_, 0u);
+}
+
+
+TEST(Instrumentation, threads) {
+
+    if (!headcode::url::IsInstrumentationEnabled()) {
+        GTEST_SKIP();
+    }
+
+    headcode::url::ResetParseStatistics();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 100; ++i) {
+                headcode::url::URL{"https://www.example.com/path?query"};
+            }
+        });
+    }
+
+    // aggregated while the threads are still running and after they have finished
+    headcode::url::GetParseStatistics();
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    auto statistics = headcode::url::GetParseStatistics();
+    EXPECT_EQ(statistics.parses_, 400u);
+    EXPECT_EQ(statistics.errors_[static_cast<std::size_t>(headcode::url::ParseError::kNoError)], 400u);
+    EXPECT_EQ(statistics.stages_[static_cast<std::size_t>(headcode::url::ParseStage::kQuery)].count_, 400u);
+}
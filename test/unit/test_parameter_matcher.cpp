@@ -0,0 +1,111 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+// Some well known tracking parameters.
+static char const * kRules = R"(// campaign tracking
+utm_*
+fbclid
+gclid
+mc_eid
+
+// bogus rules which are ignored
+a*b
+x=y
+)";
+
+
+TEST(ParameterMatcher, empty) {
+
+    headcode::url::ParameterMatcher matcher;
+    EXPECT_EQ(matcher.GetNodeCount(), 1u);
+    EXPECT_FALSE(matcher.Matches("utm_source"));
+    EXPECT_FALSE(matcher.Matches(""));
+
+    headcode::url::URL url{"http://host/?a=1&b=2"};
+    EXPECT_EQ(matcher.Strip(url), 0u);
+    EXPECT_EQ(url.GetURL(), "http://host/?a=1&b=2");
+}
+
+
+TEST(ParameterMatcher, rules) {
+
+    headcode::url::ParameterMatcher matcher;
+    EXPECT_EQ(matcher.Compile(kRules), 4u);
+
+    EXPECT_TRUE(matcher.Matches("utm_"));
+    EXPECT_TRUE(matcher.Matches("utm_source"));
+    EXPECT_TRUE(matcher.Matches("utm_medium"));
+    EXPECT_TRUE(matcher.Matches("fbclid"));
+    EXPECT_TRUE(matcher.Matches("gclid"));
+    EXPECT_TRUE(matcher.Matches("mc_eid"));
+
+    EXPECT_FALSE(matcher.Matches(""));
+    EXPECT_FALSE(matcher.Matches("utm"));
+    EXPECT_FALSE(matcher.Matches("UTM_source"));
+    EXPECT_FALSE(matcher.Matches("fbclid2"));
+    EXPECT_FALSE(matcher.Matches("fbcli"));
+    EXPECT_FALSE(matcher.Matches("mc"));
+    EXPECT_FALSE(matcher.Matches("ab"));
+    EXPECT_FALSE(matcher.Matches("x"));
+
+    EXPECT_TRUE(matcher.MatchesItem("fbclid=abc"));
+    EXPECT_TRUE(matcher.MatchesItem("fbclid"));
+    EXPECT_TRUE(matcher.MatchesItem("utm_source=a=b"));
+    EXPECT_FALSE(matcher.MatchesItem("id=fbclid"));
+
+    // compiling again drops the previous rules
+    EXPECT_EQ(matcher.Compile("id"), 1u);
+    EXPECT_EQ(matcher.GetNodeCount(), 3u);
+    EXPECT_TRUE(matcher.Matches("id"));
+    EXPECT_FALSE(matcher.Matches("fbclid"));
+}
+
+
+TEST(ParameterMatcher, wildcard) {
+
+    headcode::url::ParameterMatcher matcher{"*"};
+    EXPECT_TRUE(matcher.Matches(""));
+    EXPECT_TRUE(matcher.Matches("anything"));
+
+    headcode::url::URL url{"http://host/path?a=1&b=2#top"};
+    EXPECT_EQ(matcher.Strip(url), 2u);
+    EXPECT_EQ(url.GetURL(), "http://host/path#top");
+    EXPECT_FALSE(url.IsQueryPresent());
+}
+
+
+TEST(ParameterMatcher, strip) {
+
+    headcode::url::ParameterMatcher matcher{kRules};
+
+    headcode::url::URL url{"https://www.example.com/a/b?utm_source=news&id=1&fbclid=x&utm_medium=mail&page=2#top"};
+    EXPECT_EQ(matcher.Strip(url), 3u);
+    EXPECT_EQ(url.GetURL(), "https://www.example.com/a/b?id=1&page=2#top");
+    EXPECT_TRUE(url.GetQuery() == "id=1&page=2");
+    EXPECT_TRUE(url.GetFragment() == "top");
+    EXPECT_EQ(url.GetQueryItems(), (std::vector<std::string_view>{"id=1", "page=2"}));
+
+    // the stripped URL equals a fresh parse
+    headcode::url::URL parsed{url.GetURL()};
+    EXPECT_TRUE(parsed.IsValid());
+    EXPECT_EQ(url.GetQueryItems(), parsed.GetQueryItems());
+    EXPECT_TRUE(url.GetFragment() == parsed.GetFragment());
+
+    url.Assign("https://www.example.com/?gclid=1&utm_campaign=2");
+    EXPECT_EQ(matcher.Strip(url), 2u);
+    EXPECT_EQ(url.GetURL(), "https://www.example.com/");
+    EXPECT_FALSE(url.IsQueryPresent());
+
+    headcode::url::URL invalid{"http://host/bad path?utm_source=x"};
+    EXPECT_EQ(matcher.Strip(invalid), 0u);
+}
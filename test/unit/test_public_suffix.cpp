@@ -0,0 +1,161 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+// Excerpt of the Public Suffix List (https://publicsuffix.org), including the
+// special cases of the test data of the list itself.
+static char const * kRules = R"(// ===BEGIN ICANN DOMAINS===
+com
+uk
+co.uk
+ac.uk
+
+// jp : https://en.wikipedia.org/wiki/.jp
+jp
+ac.jp
+*.kawasaki.jp
+!city.kawasaki.jp
+
+*.ck
+!www.ck
+
+// bogus rules which are ignored
+a.*.b
+..
+)";
+
+
+TEST(PublicSuffixList, empty) {
+
+    headcode::url::PublicSuffixList psl;
+    EXPECT_EQ(psl.GetNodeCount(), 1u);
+
+    // the implicit default rule "*" applies
+    EXPECT_TRUE(psl.GetPublicSuffix("www.example.com") == "com");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.example.com") == "example.com");
+    EXPECT_TRUE(psl.GetPublicSuffix("com") == "com");
+    EXPECT_TRUE(psl.GetRegistrableDomain("com").empty());
+}
+
+
+TEST(PublicSuffixList, rules) {
+
+    headcode::url::PublicSuffixList psl;
+    EXPECT_EQ(psl.Compile(kRules), 10u);
+
+    EXPECT_TRUE(psl.GetPublicSuffix("example.com") == "com");
+    EXPECT_TRUE(psl.GetRegistrableDomain("example.com") == "example.com");
+    EXPECT_TRUE(psl.GetRegistrableDomain("a.b.example.com") == "example.com");
+    EXPECT_TRUE(psl.GetRegistrableDomain("WWW.Example.COM") == "Example.COM");
+
+    EXPECT_TRUE(psl.GetPublicSuffix("www.example.co.uk") == "co.uk");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.example.co.uk") == "example.co.uk");
+    EXPECT_TRUE(psl.GetPublicSuffix("co.uk") == "co.uk");
+    EXPECT_TRUE(psl.GetRegistrableDomain("co.uk").empty());
+    EXPECT_TRUE(psl.GetRegistrableDomain("example.uk") == "example.uk");
+
+    // unlisted TLD: default rule
+    EXPECT_TRUE(psl.GetPublicSuffix("example.example") == "example");
+    EXPECT_TRUE(psl.GetRegistrableDomain("b.example.example") == "example.example");
+
+    // wildcards and exceptions
+    EXPECT_TRUE(psl.GetPublicSuffix("www.kawasaki.jp") == "www.kawasaki.jp");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.kawasaki.jp").empty());
+    EXPECT_TRUE(psl.GetRegistrableDomain("b.test.kawasaki.jp") == "b.test.kawasaki.jp");
+    EXPECT_TRUE(psl.GetPublicSuffix("city.kawasaki.jp") == "kawasaki.jp");
+    EXPECT_TRUE(psl.GetRegistrableDomain("city.kawasaki.jp") == "city.kawasaki.jp");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.city.kawasaki.jp") == "city.kawasaki.jp");
+    EXPECT_TRUE(psl.GetRegistrableDomain("c.ck").empty());
+    EXPECT_TRUE(psl.GetRegistrableDomain("b.c.ck") == "b.c.ck");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.ck") == "www.ck");
+    EXPECT_TRUE(psl.GetRegistrableDomain("a.www.ck") == "www.ck");
+
+    // trailing dots of FQDNs are dropped
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.example.co.uk.") == "example.co.uk");
+
+    // no public suffix
+    EXPECT_TRUE(psl.GetPublicSuffix("").empty());
+    EXPECT_TRUE(psl.GetPublicSuffix(".com").empty());
+    EXPECT_TRUE(psl.GetPublicSuffix("example..com").empty());
+    EXPECT_TRUE(psl.GetPublicSuffix("192.168.1.1").empty());
+    EXPECT_TRUE(psl.GetPublicSuffix("::1").empty());
+}
+
+
+TEST(PublicSuffixList, url) {
+
+    headcode::url::PublicSuffixList psl;
+    psl.Compile(kRules);
+
+    headcode::url::URL url{"https://user@www.example.co.uk:8080/path?query"};
+    ASSERT_TRUE(url.IsValid());
+    EXPECT_TRUE(psl.GetPublicSuffix(url) == "co.uk");
+    EXPECT_TRUE(psl.GetRegistrableDomain(url) == "example.co.uk");
+
+    url = headcode::url::URL{"https://[::1]/path"};
+    ASSERT_TRUE(url.IsValid());
+    EXPECT_TRUE(psl.GetPublicSuffix(url).empty());
+    EXPECT_TRUE(psl.GetRegistrableDomain(url).empty());
+
+    url = headcode::url::URL{"file:///tmp"};
+    ASSERT_TRUE(url.IsValid());
+    EXPECT_TRUE(psl.GetRegistrableDomain(url).empty());
+}
+
+
+TEST(PublicSuffixList, serialize) {
+
+    headcode::url::PublicSuffixList psl;
+    psl.Compile(kRules);
+    auto data = psl.Serialize();
+
+    headcode::url::PublicSuffixList restored;
+    ASSERT_TRUE(restored.Deserialize(data));
+    EXPECT_EQ(restored.GetNodeCount(), psl.GetNodeCount());
+    EXPECT_EQ(restored.Serialize(), data);
+    EXPECT_TRUE(restored.GetRegistrableDomain("www.example.co.uk") == "example.co.uk");
+    EXPECT_TRUE(restored.GetRegistrableDomain("www.city.kawasaki.jp") == "city.kawasaki.jp");
+
+    // bad data is refused and leaves the list untouched
+    EXPECT_FALSE(restored.Deserialize(std::string_view{}));
+    EXPECT_FALSE(restored.Deserialize("garbage"));
+    EXPECT_FALSE(restored.Deserialize(std::string_view{data}.substr(0, data.size() - 1)));
+    auto bad_version = data;
+    bad_version[6] = 0x7f;
+    EXPECT_FALSE(restored.Deserialize(bad_version));
+    EXPECT_TRUE(restored.GetRegistrableDomain("www.example.co.uk") == "example.co.uk");
+}
+
+
+TEST(PublicSuffixList, many_children) {
+
+    // more children below a single node than a 16 bit count holds
+    std::string rules;
+    for (unsigned int i = 0; i < 70000u; ++i) {
+        rules += "c" + std::to_string(i) + ".uk\n";
+    }
+    headcode::url::PublicSuffixList psl;
+    EXPECT_EQ(psl.Compile(rules), 70000u);
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.example.c0.uk") == "example.c0.uk");
+    EXPECT_TRUE(psl.GetRegistrableDomain("www.example.c69999.uk") == "example.c69999.uk");
+
+    headcode::url::PublicSuffixList restored;
+    ASSERT_TRUE(restored.Deserialize(psl.Serialize()));
+    EXPECT_TRUE(restored.GetRegistrableDomain("www.example.c69999.uk") == "example.c69999.uk");
+}
+
+
+TEST(PublicSuffixList, file) {
+
+    headcode::url::PublicSuffixList psl;
+    EXPECT_FALSE(psl.LoadFile("/this/file/does/not/exist"));
+}
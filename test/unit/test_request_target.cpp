@@ -0,0 +1,206 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+TEST(RequestTarget, empty) {
+
+    headcode::url::RequestTarget target;
+    EXPECT_FALSE(target.IsValid());
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kURLEmpty);
+
+    target.Assign("");
+    EXPECT_FALSE(target.IsValid());
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kURLEmpty);
+}
+
+
+TEST(RequestTarget, origin_form) {
+
+    std::string line{"/where/to?q=now&page=2"};
+    headcode::url::RequestTarget target{line};
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kOrigin);
+    EXPECT_EQ(target.GetPath(), "/where/to");
+    EXPECT_TRUE(target.IsQueryPresent());
+    EXPECT_EQ(target.GetQuery(), "q=now&page=2");
+    EXPECT_TRUE(target.GetScheme().empty());
+    EXPECT_TRUE(target.GetHost().empty());
+
+    // zero-copy: the components are views into the target
+    EXPECT_EQ(target.GetPath().data(), line.data());
+    EXPECT_EQ(target.GetQuery().data(), line.data() + 10);
+
+    target.Assign("/");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetPath(), "/");
+    EXPECT_FALSE(target.IsQueryPresent());
+
+    target.Assign("/?");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetPath(), "/");
+    EXPECT_TRUE(target.IsQueryPresent());
+    EXPECT_TRUE(target.GetQuery().empty());
+
+    target.Assign("//double/slash");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kOrigin);
+    EXPECT_EQ(target.GetPath(), "//double/slash");
+    EXPECT_TRUE(target.GetHost().empty());
+
+    target.Assign("/a b");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidPath);
+    target.Assign("/a?b c");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidQuery);
+    target.Assign("/a#top");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidFragment);
+    target.Assign("/a?b#top");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidFragment);
+}
+
+
+TEST(RequestTarget, absolute_form) {
+
+    headcode::url::RequestTarget target{"http://user@www.example.org:8080/pub/WWW/?x=1"};
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kAbsolute);
+    EXPECT_EQ(target.GetScheme(), "http");
+    EXPECT_EQ(target.GetSchemeKind(), headcode::url::SchemeKind::kHttp);
+    EXPECT_EQ(target.GetAuthority(), "user@www.example.org:8080");
+    EXPECT_EQ(target.GetUserInfo(), "user");
+    EXPECT_EQ(target.GetHost(), "www.example.org");
+    EXPECT_EQ(target.GetPort(), "8080");
+    EXPECT_EQ(target.GetPortNumber(), 8080);
+    EXPECT_EQ(target.GetPath(), "/pub/WWW/");
+    EXPECT_EQ(target.GetQuery(), "x=1");
+
+    target.Assign("https://[::1]");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetHost(), "::1");
+    EXPECT_EQ(target.GetHostAddress().type_, headcode::url::HostType::kIPv6);
+    EXPECT_TRUE(target.GetPath().empty());
+
+    target.Assign("urn:isbn:0451450523");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetScheme(), "urn");
+    EXPECT_TRUE(target.GetAuthority().empty());
+    EXPECT_EQ(target.GetPath(), "isbn:0451450523");
+
+    target.Assign("http://www.example.org/#top");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidFragment);
+    target.Assign("http://www.exa mple.org/");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidHost);
+    target.Assign("1http://www.example.org/");
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidSchemeChar);
+
+    // a host and port looks like an absolute URI without the CONNECT method
+    target.Assign("www.example.com:443");
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kAbsolute);
+    EXPECT_EQ(target.GetScheme(), "www.example.com");
+    EXPECT_EQ(target.GetPath(), "443");
+}
+
+
+TEST(RequestTarget, authority_form) {
+
+    headcode::url::RequestTarget target{"www.example.com:443", true};
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kAuthority);
+    EXPECT_EQ(target.GetAuthority(), "www.example.com:443");
+    EXPECT_EQ(target.GetHost(), "www.example.com");
+    EXPECT_EQ(target.GetPortNumber(), 443);
+    EXPECT_TRUE(target.GetScheme().empty());
+    EXPECT_TRUE(target.GetPath().empty());
+
+    target.Assign("[2001:db8::7]:8443", true);
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetHost(), "2001:db8::7");
+    EXPECT_EQ(target.GetPortNumber(), 8443);
+
+    target.Assign("www.example.com", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidPort);
+    target.Assign("www.example.com:", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidPort);
+    target.Assign("www.example.com:99999", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidPort);
+    target.Assign("user@www.example.com:443", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidUserInfo);
+    target.Assign(":443", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidHost);
+    target.Assign("www.example.com:443/", true);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kInvalidPath);
+    target.Assign("/", true);
+    EXPECT_FALSE(target.IsValid());
+}
+
+
+TEST(RequestTarget, asterisk_form) {
+
+    headcode::url::RequestTarget target{"*"};
+    EXPECT_TRUE(target.IsValid());
+    EXPECT_EQ(target.GetForm(), headcode::url::RequestTargetForm::kAsterisk);
+    EXPECT_TRUE(target.GetPath().empty());
+
+    target.Assign("**");
+    EXPECT_FALSE(target.IsValid());
+    target.Assign("*", true);
+    EXPECT_FALSE(target.IsValid());
+}
+
+
+TEST(RequestTarget, limits) {
+
+    headcode::url::ParseLimits limits;
+    limits.max_length_ = 8;
+    headcode::url::RequestTarget target{"/a/b/c/d/e", false, limits};
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kURLTooLong);
+
+    limits = headcode::url::ParseLimits{};
+    limits.max_segments_ = 2;
+    target.Assign("/a/b", false, limits);
+    EXPECT_TRUE(target.IsValid());
+    target.Assign("/a/b/c", false, limits);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kTooManySegments);
+
+    limits = headcode::url::ParseLimits{};
+    limits.max_query_items_ = 1;
+    target.Assign("/?a=1", false, limits);
+    EXPECT_TRUE(target.IsValid());
+    target.Assign("/?a=1&b=2", false, limits);
+    EXPECT_EQ(target.GetError(), headcode::url::ParseError::kTooManyQueryItems);
+}
+
+
+TEST(RequestTarget, exact_buffers) {
+
+    // request lines are not NUL terminated: nothing is read past the target
+    auto parse = [](std::string_view raw, bool connect) {
+        std::vector<char> buffer{raw.begin(), raw.end()};
+        return headcode::url::RequestTarget{std::string_view{buffer.data(), buffer.size()}, connect}.IsValid();
+    };
+
+    EXPECT_FALSE(parse("%", true));
+    EXPECT_FALSE(parse("a%:80", true));
+    EXPECT_FALSE(parse("/%", false));
+    EXPECT_FALSE(parse("/a/%4", false));
+    EXPECT_FALSE(parse("/?%", false));
+    EXPECT_FALSE(parse("http://h%", false));
+    EXPECT_FALSE(parse("http://u%@h/", false));
+    EXPECT_FALSE(parse("http:/%", false));
+    EXPECT_TRUE(parse("/a/%41", false));
+    EXPECT_TRUE(parse("/?%41", false));
+    EXPECT_TRUE(parse("http://h", false));
+    EXPECT_TRUE(parse("h:1", true));
+}
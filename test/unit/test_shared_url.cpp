@@ -0,0 +1,125 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+TEST(SharedURL, empty) {
+
+    headcode::url::SharedURL url1;
+    headcode::url::SharedURL url2;
+    EXPECT_FALSE(url1->IsValid());
+    EXPECT_EQ(url1->GetError(), headcode::url::ParseError::kURLEmpty);
+    EXPECT_EQ(&url1.Get(), &url2.Get());
+}
+
+
+TEST(SharedURL, copy) {
+
+    headcode::url::SharedURL url{"https://www.example.com/a/b?c&d#e"};
+    EXPECT_TRUE(url->IsValid());
+    EXPECT_FALSE(url.IsShared());
+
+    auto copy = url;
+    EXPECT_TRUE(url.IsShared());
+    EXPECT_EQ(url.GetUseCount(), 2);
+    EXPECT_EQ(&url.Get(), &copy.Get());
+    EXPECT_EQ(&url->GetURL(), &copy->GetURL());
+    EXPECT_TRUE(copy->GetHost() == "www.example.com");
+    EXPECT_EQ(copy->GetSegments().size(), 2u);
+
+    headcode::url::SharedURL moved{std::move(copy)};
+    EXPECT_EQ(url.GetUseCount(), 2);
+    EXPECT_EQ(&url.Get(), &moved.Get());
+
+    headcode::url::SharedURL parsed{headcode::url::URL{"http://host/"}};
+    EXPECT_TRUE(parsed->GetHost() == "host");
+    headcode::url::SharedURL trusted{"http://host/", headcode::url::kTrustedInput};
+    EXPECT_TRUE(trusted->IsValid());
+    headcode::url::SharedURL limited{"http://host/a/b", headcode::url::ParseLimits{100, 1, 100}};
+    EXPECT_EQ(limited->GetError(), headcode::url::ParseError::kTooManySegments);
+}
+
+
+TEST(SharedURL, copy_on_write) {
+
+    headcode::url::SharedURL url{"https://www.example.com/a"};
+    auto original = &url.Get();
+
+    // not shared: modified in place
+    EXPECT_TRUE(url.Mutable().AppendSegment("b"));
+    EXPECT_EQ(&url.Get(), original);
+
+    // shared: detached before modification
+    auto copy = url;
+    EXPECT_TRUE(copy.Mutable().SetHost("example.org"));
+    EXPECT_NE(&copy.Get(), original);
+    EXPECT_EQ(&url.Get(), original);
+    EXPECT_FALSE(url.IsShared());
+    EXPECT_FALSE(copy.IsShared());
+    EXPECT_EQ(url->GetURL(), "https://www.example.com/a/b");
+    EXPECT_EQ(copy->GetURL(), "https://example.org/a/b");
+
+    headcode::url::SharedURL empty;
+    empty.Mutable().Assign("http://host");
+    EXPECT_TRUE(empty->IsValid());
+    EXPECT_FALSE(headcode::url::SharedURL{}->IsValid());
+}
+
+
+TEST(SharedURL, threads) {
+
+    headcode::url::SharedURL url{"https://www.example.com/a/b?c&d"};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([url] {
+            for (int i = 0; i < 1000; ++i) {
+                auto copy = url;
+                EXPECT_TRUE(copy->GetHost() == "www.example.com");
+            }
+            auto mine = url;
+            mine.Mutable().AppendQueryItem("e");
+            EXPECT_EQ(mine->GetURL(), "https://www.example.com/a/b?c&d&e");
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(url->GetURL(), "https://www.example.com/a/b?c&d");
+    EXPECT_FALSE(url.IsShared());
+}
+
+
+TEST(SharedURL, modify_after_release) {
+
+    // the last other copy is dropped by another thread, which still runs: modified in place
+    headcode::url::SharedURL url{"https://www.example.com/a"};
+    auto address = &url.Get();
+    std::atomic<bool> done{false};
+    std::thread reader{[copy = url, &done]() mutable {
+        EXPECT_TRUE(copy->GetHost() == "www.example.com");
+        copy = headcode::url::SharedURL{};
+        done = true;
+    }};
+    while (!done) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(url.IsShared());
+    url.Mutable().AppendSegment("b");
+    EXPECT_EQ(&url.Get(), address);
+    EXPECT_EQ(url->GetURL(), "https://www.example.com/a/b");
+    reader.join();
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+TEST(URLCache, hit) {
+
+    headcode::url::URLCache cache{100};
+    EXPECT_EQ(cache.GetCapacity(), 112u);        // rounded up to 16 shards of 7
+
+    auto url1 = cache.Get("https://www.example.com/a/b?c#d");
+    EXPECT_TRUE(url1->IsValid());
+    EXPECT_TRUE(url1->GetHost() == "www.example.com");
+
+    std::string raw{"https://www.example.com/a/b?c#d"};
+    auto url2 = cache.Get(raw);
+    EXPECT_EQ(&url1.Get(), &url2.Get());
+
+    auto invalid1 = cache.Get("http://host/a b");
+    auto invalid2 = cache.Get("http://host/a b");
+    EXPECT_EQ(invalid1->GetError(), headcode::url::ParseError::kInvalidPath);
+    EXPECT_EQ(&invalid1.Get(), &invalid2.Get());
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits_, 2u);
+    EXPECT_EQ(statistics.misses_, 2u);
+    EXPECT_EQ(statistics.evictions_, 0u);
+    EXPECT_EQ(statistics.size_, 2u);
+
+    cache.Clear();
+    EXPECT_EQ(cache.GetStatistics().size_, 0u);
+    auto url3 = cache.Get("https://www.example.com/a/b?c#d");
+    EXPECT_NE(&url1.Get(), &url3.Get());
+    EXPECT_EQ(url1->GetURL(), url3->GetURL());
+    EXPECT_EQ(cache.GetStatistics().misses_, 3u);
+}
+
+
+TEST(URLCache, clock) {
+
+    // a single shard of 3 entries
+    headcode::url::URLCache cache{3, 1};
+
+    auto a = cache.Get("http://a/");
+    auto b = cache.Get("http://b/");
+    auto c = cache.Get("http://c/");
+    (void)cache.Get("http://a/");        // a is referenced
+
+    // the clock hand passes a (clearing its bit) and evicts b
+    (void)cache.Get("http://d/");
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.evictions_, 1u);
+    EXPECT_EQ(statistics.size_, 3u);
+
+    EXPECT_EQ(&cache.Get("http://a/").Get(), &a.Get());
+    EXPECT_NE(&cache.Get("http://b/").Get(), &b.Get());
+
+    // the evicted URL is still valid for its holder
+    EXPECT_TRUE(b->GetHost() == "b");
+}
+
+
+TEST(URLCache, disabled) {
+
+    headcode::url::URLCache cache{0};
+    auto url1 = cache.Get("http://host/");
+    auto url2 = cache.Get("http://host/");
+    EXPECT_TRUE(url1->IsValid());
+    EXPECT_NE(&url1.Get(), &url2.Get());
+    EXPECT_EQ(cache.GetStatistics().misses_, 2u);
+    EXPECT_EQ(cache.GetStatistics().size_, 0u);
+}
+
+
+TEST(URLCache, limits) {
+
+    headcode::url::URLCache cache{10, 2, headcode::url::ParseLimits{16, 100, 100}};
+    EXPECT_EQ(cache.Get("http://host/a/very/long/path")->GetError(), headcode::url::ParseError::kURLTooLong);
+    EXPECT_TRUE(cache.Get("http://host/")->IsValid());
+
+    // too long URLs are neither held nor counted
+    std::string huge = "http://host/" + std::string(1000000, 'a');
+    auto rejected = cache.Get(huge);
+    EXPECT_EQ(rejected->GetError(), headcode::url::ParseError::kURLTooLong);
+    EXPECT_EQ(rejected->GetURL().size(), 17u);
+    EXPECT_EQ(cache.GetStatistics().size_, 1u);
+    EXPECT_EQ(cache.GetStatistics().misses_, 1u);
+}
+
+
+TEST(URLCache, threads) {
+
+    headcode::url::URLCache cache{64, 4};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t] {
+            for (int i = 0; i < 2000; ++i) {
+                auto raw = "http://host" + std::to_string((i * 7 + t) % 100) + "/path?q";
+                auto url = cache.Get(raw);
+                EXPECT_EQ(url->GetURL(), raw);
+                EXPECT_TRUE(url->IsValid());
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits_ + statistics.misses_, 8000u);
+    EXPECT_LE(statistics.size_, cache.GetCapacity());
+}
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+TEST(StringDictionary, regular) {
+
+    headcode::url::StringDictionary dictionary;
+    EXPECT_EQ(dictionary.Size(), 0u);
+    EXPECT_EQ(dictionary.Find("foo"), headcode::url::StringDictionary::kNotFound);
+
+    EXPECT_EQ(dictionary.Insert("foo"), 0u);
+    EXPECT_EQ(dictionary.Insert("bar"), 1u);
+    EXPECT_EQ(dictionary.Insert("foo"), 0u);
+    EXPECT_EQ(dictionary.Insert(""), 2u);
+    EXPECT_EQ(dictionary.Size(), 3u);
+    EXPECT_EQ(dictionary.Find("bar"), 1u);
+    EXPECT_EQ(dictionary.Find(""), 2u);
+    EXPECT_TRUE(dictionary.Get(0) == "foo");
+    EXPECT_TRUE(dictionary.Get(1) == "bar");
+    EXPECT_TRUE(dictionary.Get(2).empty());
+
+    // many entries: the hash table grows
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(dictionary.Insert("host" + std::to_string(i)), i + 3);
+    }
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(dictionary.Find("host" + std::to_string(i)), i + 3);
+    }
+    EXPECT_EQ(dictionary.Size(), 1003u);
+
+    dictionary.Clear();
+    EXPECT_EQ(dictionary.Size(), 0u);
+    EXPECT_EQ(dictionary.Find("foo"), headcode::url::StringDictionary::kNotFound);
+}
+
+
+TEST(URLColumns, regular) {
+
+    headcode::url::URLColumns columns;
+    columns.Reserve(4);
+    columns.Append("https://www.example.com/a/path?query#fragment");
+    columns.Append("http://www.example.com/other");
+    columns.Append("https://www.headcode.space/?");
+    columns.Append(headcode::url::URL{"http://www.example.com/bad path"});
+
+    ASSERT_EQ(columns.Size(), 4u);
+    EXPECT_EQ(columns.GetSchemes().Size(), 2u);
+    EXPECT_EQ(columns.GetHosts().Size(), 2u);
+
+    EXPECT_TRUE(columns.GetScheme(0) == "https");
+    EXPECT_TRUE(columns.GetScheme(1) == "http");
+    EXPECT_TRUE(columns.GetScheme(2) == "https");
+    EXPECT_EQ(columns.GetSchemeIds()[0], columns.GetSchemeIds()[2]);
+
+    EXPECT_TRUE(columns.GetHost(0) == "www.example.com");
+    EXPECT_TRUE(columns.GetHost(2) == "www.headcode.space");
+    EXPECT_EQ(columns.GetHostIds()[0], columns.GetHostIds()[1]);
+    EXPECT_EQ(columns.GetHosts().Find("www.headcode.space"), columns.GetHostIds()[2]);
+
+    EXPECT_TRUE(columns.GetPath(0) == "/a/path");
+    EXPECT_TRUE(columns.GetPath(1) == "/other");
+    EXPECT_TRUE(columns.GetPath(2) == "/");
+    EXPECT_TRUE(columns.GetQuery(0) == "query");
+    EXPECT_TRUE(columns.GetQuery(1).empty());
+    EXPECT_TRUE(columns.GetFragment(0) == "fragment");
+
+    EXPECT_TRUE(columns.IsQueryPresent(0));
+    EXPECT_TRUE(columns.IsFragmentPresent(0));
+    EXPECT_FALSE(columns.IsQueryPresent(1));
+    EXPECT_FALSE(columns.IsFragmentPresent(1));
+    EXPECT_TRUE(columns.IsQueryPresent(2));
+    EXPECT_FALSE(columns.IsFragmentPresent(2));
+    EXPECT_EQ(columns.GetFlags().size(), 4u);
+
+    EXPECT_EQ(columns.GetError(0), headcode::url::ParseError::kNoError);
+    EXPECT_EQ(columns.GetError(3), headcode::url::ParseError::kInvalidPath);
+    EXPECT_EQ(columns.GetErrors().size(), 4u);
+
+    // count by host
+    std::vector<std::size_t> count_by_host(columns.GetHosts().Size());
+    for (auto id : columns.GetHostIds()) {
+        count_by_host[id]++;
+    }
+    EXPECT_EQ(count_by_host[columns.GetHosts().Find("www.example.com")], 3u);
+
+    columns.Clear();
+    EXPECT_EQ(columns.Size(), 0u);
+    EXPECT_EQ(columns.GetHosts().Size(), 0u);
+    columns.Append("ftp://ftp.example.com/file");
+    EXPECT_TRUE(columns.GetPath(0) == "/file");
+    EXPECT_TRUE(columns.GetHost(0) == "ftp.example.com");
+}
@@ -0,0 +1,166 @@
+/*
+ * This file is part of the headcode.space url.
+ *
+ * The 'LICENSE.txt' file in the project root holds the software license.
+ * Copyright (C) 2021 headcode.space e.U.
+ * Oliver Maurhart <info@headcode.space>, https://www.headcode.space
+ */
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <headcode/url/url.hpp>
+
+
+namespace {
+
+/**
+ * @brief   Collects all URL candidates of a text.
+ * @param   text        the text to scan.
+ * @return  The candidates found.
+ */
+std::vector<std::string_view> Scan(std::string_view text) {
+    std::vector<std::string_view> found;
+    headcode::url::URLScanner scanner{text};
+    std::string_view url;
+    while (scanner.Next(url)) {
+        found.push_back(url);
+    }
+    EXPECT_EQ(scanner.GetPosition(), text.size());
+    return found;
+}
+
+}
+
+
+TEST(URLScanner, empty) {
+    EXPECT_TRUE(Scan("").empty());
+    EXPECT_TRUE(Scan("no urls: here, 12:34:56").empty());
+    EXPECT_TRUE(Scan("://host").empty());
+    EXPECT_TRUE(Scan("http://").empty());
+    EXPECT_TRUE(Scan("http:// host").empty());
+    EXPECT_TRUE(Scan("http://...").empty());
+    EXPECT_TRUE(Scan("123://host").empty());
+}
+
+
+TEST(URLScanner, text) {
+
+    using V = std::vector<std::string_view>;
+
+    EXPECT_EQ(Scan("http://host"), (V{"http://host"}));
+    EXPECT_EQ(Scan("see https://www.example.com/a/b?c=d&e#f for details"),
+              (V{"https://www.example.com/a/b?c=d&e#f"}));
+    EXPECT_EQ(Scan("2021-01-01 12:00:00 GET http://a/1 -> ftp://b:21/2\nhttp://c/3"),
+              (V{"http://a/1", "ftp://b:21/2", "http://c/3"}));
+
+    // the scheme starts with a letter right before the "://"
+    EXPECT_EQ(Scan("x-http://host/ ...svn+ssh://host/repo 42ws://host"),
+              (V{"x-http://host/", "svn+ssh://host/repo", "ws://host"}));
+
+    // trailing punctuation belongs to the text
+    EXPECT_EQ(Scan("Go to http://host/a. Or http://host/b, http://host/c; http://host/d! 'http://host/e'?"),
+              (V{"http://host/a", "http://host/b", "http://host/c", "http://host/d", "http://host/e"}));
+
+    // balanced brackets stay, unbalanced ones are cut off
+    EXPECT_EQ(Scan("(see http://en.wikipedia.org/wiki/URL_(disambiguation)) [http://[::1]:80/]"),
+              (V{"http://en.wikipedia.org/wiki/URL_(disambiguation)", "http://[::1]:80/"}));
+    EXPECT_EQ(Scan("[link](https://example.com/path)"), (V{"https://example.com/path"}));
+
+    // quoted
+    EXPECT_EQ(Scan("'http://host/it's' \"http://host/b\""), (V{"http://host/it", "http://host/b"}));
+    EXPECT_EQ(Scan("'http://host/a b"), (V{"http://host/a"}));
+
+    // percent encodings, but not a lone '%'
+    EXPECT_EQ(Scan("http://host/a%20b%zz"), (V{"http://host/a%20b"}));
+
+    // HTML
+    EXPECT_EQ(Scan(R"(<a href="https://example.com/?a=1&amp;b=2">x</a><img src='http://img/x.png'/>)"),
+              (V{"https://example.com/?a=1&amp;b=2", "http://img/x.png"}));
+}
+
+
+TEST(URLScanner, characters) {
+
+    // each character at each position of a 16 byte block
+    std::string_view valid{"-._~:/?#[]@!$&'()*+,;=%"};
+    for (int c = 1; c < 256; ++c) {
+        auto ch = static_cast<char>(c);
+        bool is_valid = std::isalnum(c) || (valid.find(ch) != std::string_view::npos);
+        for (std::size_t position = 0; position < 16; ++position) {
+            std::string text = "http://h/" + std::string(position + 16, 'a') + ch + std::string(32, 'b');
+            auto found = Scan(text);
+            ASSERT_EQ(found.size(), 1u);
+            EXPECT_EQ(found[0].size(), is_valid ? text.size() : 9 + position + 16) << c << " at " << position;
+        }
+    }
+}
+
+TEST(URLScanner, views) {
+
+    std::string text = "foo http://host/path bar";
+    headcode::url::URLScanner scanner{text};
+    std::string_view url;
+    ASSERT_TRUE(scanner.Next(url));
+    EXPECT_EQ(url.data(), text.data() + 4);
+    EXPECT_EQ(url.size(), 16u);
+    EXPECT_EQ(scanner.GetPosition(), 20u);
+    EXPECT_FALSE(scanner.Next(url));
+    EXPECT_FALSE(scanner.Next(url));
+}
+
+
+TEST(URLScanner, parsed) {
+
+    // bad IPv6 and bad port are skipped
+    headcode::url::URLScanner scanner{"a http://[::1/ b https://www.example.com:8080/x?y c http://h:99999/ d ws://h"};
+    headcode::url::URL url;
+
+    ASSERT_TRUE(scanner.Next(url));
+    EXPECT_TRUE(url.GetHost() == "www.example.com");
+    EXPECT_EQ(url.GetPortNumber(), 8080u);
+    EXPECT_TRUE(url.GetQuery() == "y");
+
+    ASSERT_TRUE(scanner.Next(url));
+    EXPECT_EQ(url.GetSchemeKind(), headcode::url::SchemeKind::kWs);
+
+    EXPECT_FALSE(scanner.Next(url));
+}
+
+
+TEST(URLScanner, large) {
+
+    std::string text;
+    for (int i = 0; i < 10000; ++i) {
+        text += "line " + std::to_string(i) + " at 12:34:56: fetched https://host/" + std::to_string(i) + ".\n";
+    }
+
+    auto found = Scan(text);
+    ASSERT_EQ(found.size(), 10000u);
+    EXPECT_EQ(found.front(), "https://host/0");
+    EXPECT_EQ(found.back(), "https://host/9999");
+}
+
+
+TEST(URLScanner, quoted) {
+
+    // every candidate is cut at the next quote: the scan must not extend over the following ones again
+    std::string text;
+    for (int i = 0; i < 80000; ++i) {
+        text += "'a://";
+    }
+    EXPECT_TRUE(Scan(text).empty());
+
+    text.clear();
+    for (int i = 0; i < 10000; ++i) {
+        text += "'a://b''c://d/" + std::to_string(i) + "'";
+    }
+    auto found = Scan(text);
+    ASSERT_EQ(found.size(), 20000u);
+    EXPECT_EQ(found[0], "a://b");
+    EXPECT_EQ(found[1], "c://d/0");
+    EXPECT_EQ(found.back(), "c://d/9999");
+}